@@ -1,123 +1,540 @@
 #include <bits/stdc++.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GAUSSIAN_NB_X86 1
+#endif
 using namespace std;
 
+// --- Compiled Gaussian model: classes x features tables scored in log space ---
+// log p(c | x) = bias[c] - 0.5 * sum_j invVar[c][j] * (x_j - mean[c][j])^2 + const, with
+// bias[c] = log prior + sum_j logNorm[c][j] and logNorm = -0.5 * log(2 pi var).
+// The batch kernel reads feature columns with consecutive rows in the SIMD lanes
+// (AVX-512 / AVX2+FMA / scalar, chosen at runtime); the SIMD paths may differ from
+// scoreRow() in the last bit. A missing (NaN) feature is left out of that row's score
+// instead of poisoning it.
+class CompiledGaussianNB {
+public:
+    enum Isa { SCALAR, AVX2, AVX512 };
+
+    static constexpr double VAR_EPS = 1e-9;  // added to every variance
+
+    Isa isa;
+    int numClasses = 0, numFeatures = 0;
+    vector<double> mean, invVar, logNorm;  // numClasses x numFeatures, row-major
+    vector<double> logPrior, bias;         // per class
+
+    CompiledGaussianNB() : isa(detect()) {}
+
+    static Isa detect() {
+#ifdef GAUSSIAN_NB_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return AVX2;
+#endif
+        return SCALAR;
+    }
+
+    // --- Build from per-class priors, means and variances (classes x features, row-major) ---
+    void build(int classes, int features, const double* priors, const double* means, const double* vars) {
+        numClasses = classes;
+        numFeatures = features;
+        size_t cells = (size_t)classes * features;
+        mean.assign(means, means + cells);
+        invVar.resize(cells);
+        logNorm.resize(cells);
+        logPrior.resize(classes);
+        bias.resize(classes);
+        for (int c = 0; c < classes; c++) {
+            logPrior[c] = log(priors[c]);
+            bias[c] = logPrior[c];
+            for (int j = 0; j < features; j++) {
+                size_t k = (size_t)c * features + j;
+                if (std::isnan(means[k])) {  // no values seen: the feature carries no evidence
+                    mean[k] = invVar[k] = logNorm[k] = 0.0;
+                    continue;
+                }
+                double v = (std::isnan(vars[k]) ? 0.0 : vars[k]) + VAR_EPS;  // single-sample class
+                invVar[k] = 1.0 / v;
+                logNorm[k] = -0.5 * log(2.0 * M_PI * v);
+                bias[c] += logNorm[k];
+            }
+        }
+    }
+
+    // --- Log scores of one row-major record; returns the best class ---
+    int scoreRow(const double* x, double* scores) const {
+        for (int c = 0; c < numClasses; c++) {
+            const double* m = &mean[(size_t)c * numFeatures];
+            const double* iv = &invVar[(size_t)c * numFeatures];
+            const double* ln = &logNorm[(size_t)c * numFeatures];
+            double q = 0, partial = logPrior[c];
+            bool missing = false;
+            for (int j = 0; j < numFeatures; j++) {
+                if (std::isnan(x[j])) {
+                    missing = true;
+                    continue;
+                }
+                double t = x[j] - m[j];
+                t = t * t;
+                q += t * iv[j];
+                partial += ln[j];
+            }
+            scores[c] = (missing ? partial : bias[c]) - 0.5 * q;
+        }
+        return argmax(scores);
+    }
+
+    // --- Log scores for rows [begin, end) of feature columns cols[0 .. numFeatures) ---
+    // scores[(i - begin) * numClasses + c]; safe to call from several threads.
+    void scoreColumns(const double* const* cols, size_t begin, size_t end, double* scores) const {
+        size_t lanes = isa == AVX512 ? 16 : isa == AVX2 ? 8 : 1;
+        size_t blockEnd = begin + (end - begin) / lanes * lanes;
+        for (int c = 0; c < numClasses; c++) {
+            double* out = scores + c;
+#ifdef GAUSSIAN_NB_X86
+            if (isa == AVX512) quadAvx512(cols, c, begin, blockEnd, out - begin * numClasses);
+            else if (isa == AVX2) quadAvx2(cols, c, begin, blockEnd, out - begin * numClasses);
+            else quadScalar(cols, c, begin, blockEnd, out - begin * numClasses);
+#else
+            quadScalar(cols, c, begin, blockEnd, out - begin * numClasses);
+#endif
+            quadScalar(cols, c, blockEnd, end, out - begin * numClasses);
+        }
+
+        // Any NaN feature turns every class score into NaN; rescore those rows
+        vector<double> x;
+        for (size_t i = begin; i < end; i++) {
+            double* s = scores + (i - begin) * numClasses;
+            if (!std::isnan(s[0])) continue;
+            x.resize(numFeatures);
+            for (int j = 0; j < numFeatures; j++) x[j] = cols[j][i];
+            scoreRow(x.data(), s);
+        }
+    }
+
+    // First maximum, like a plain argmax loop
+    int argmax(const double* scores) const {
+        int best = 0;
+        for (int c = 1; c < numClasses; c++)
+            if (scores[c] > scores[best]) best = c;
+        return best;
+    }
+
+    // Posteriors from log scores via log-sum-exp
+    void normalize(const double* scores, double* out) const {
+        double top = *max_element(scores, scores + numClasses), sum = 0;
+        for (int c = 0; c < numClasses; c++) sum += out[c] = exp(scores[c] - top);
+        for (int c = 0; c < numClasses; c++) out[c] /= sum;
+    }
+
+private:
+    // out[i * numClasses] = bias[c] - 0.5 * sum_j invVar * (x - mean)^2 for rows [begin, end)
+    void quadScalar(const double* const* cols, int c, size_t begin, size_t end, double* out) const {
+        const double* m = &mean[(size_t)c * numFeatures];
+        const double* iv = &invVar[(size_t)c * numFeatures];
+        for (size_t i = begin; i < end; i++) {
+            double q = 0;
+            for (int j = 0; j < numFeatures; j++) {
+                double t = cols[j][i] - m[j];
+                t = t * t;
+                q += t * iv[j];
+            }
+            out[i * numClasses] = bias[c] - 0.5 * q;
+        }
+    }
+
+#ifdef GAUSSIAN_NB_X86
+    __attribute__((target("avx2,fma")))
+    void quadAvx2(const double* const* cols, int c, size_t begin, size_t end, double* out) const {
+        const double* m = &mean[(size_t)c * numFeatures];
+        const double* iv = &invVar[(size_t)c * numFeatures];
+        const __m256d b = _mm256_set1_pd(bias[c]), half = _mm256_set1_pd(0.5);
+        alignas(32) double tile[8];
+        for (size_t i = begin; i < end; i += 8) {
+            __m256d q0 = _mm256_setzero_pd(), q1 = _mm256_setzero_pd();
+            for (int j = 0; j < numFeatures; j++) {
+                __m256d mv = _mm256_broadcast_sd(m + j), ivv = _mm256_broadcast_sd(iv + j);
+                __m256d t0 = _mm256_sub_pd(_mm256_loadu_pd(cols[j] + i), mv);
+                __m256d t1 = _mm256_sub_pd(_mm256_loadu_pd(cols[j] + i + 4), mv);
+                q0 = _mm256_fmadd_pd(_mm256_mul_pd(t0, t0), ivv, q0);
+                q1 = _mm256_fmadd_pd(_mm256_mul_pd(t1, t1), ivv, q1);
+            }
+            _mm256_store_pd(tile, _mm256_fnmadd_pd(half, q0, b));
+            _mm256_store_pd(tile + 4, _mm256_fnmadd_pd(half, q1, b));
+            for (size_t l = 0; l < 8; l++) out[(i + l) * numClasses] = tile[l];
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void quadAvx512(const double* const* cols, int c, size_t begin, size_t end, double* out) const {
+        const double* m = &mean[(size_t)c * numFeatures];
+        const double* iv = &invVar[(size_t)c * numFeatures];
+        const __m512d b = _mm512_set1_pd(bias[c]), half = _mm512_set1_pd(0.5);
+        alignas(64) double tile[16];
+        for (size_t i = begin; i < end; i += 16) {
+            __m512d q0 = _mm512_setzero_pd(), q1 = _mm512_setzero_pd();
+            for (int j = 0; j < numFeatures; j++) {
+                __m512d mv = _mm512_set1_pd(m[j]), ivv = _mm512_set1_pd(iv[j]);
+                __m512d t0 = _mm512_sub_pd(_mm512_loadu_pd(cols[j] + i), mv);
+                __m512d t1 = _mm512_sub_pd(_mm512_loadu_pd(cols[j] + i + 8), mv);
+                q0 = _mm512_fmadd_pd(_mm512_mul_pd(t0, t0), ivv, q0);
+                q1 = _mm512_fmadd_pd(_mm512_mul_pd(t1, t1), ivv, q1);
+            }
+            _mm512_store_pd(tile, _mm512_fnmadd_pd(half, q0, b));
+            _mm512_store_pd(tile + 8, _mm512_fnmadd_pd(half, q1, b));
+            for (size_t l = 0; l < 16; l++) out[(i + l) * numClasses] = tile[l];
+        }
+    }
+#endif
+};
+
+// --- Per-class running moments for Gaussian Naive Bayes ---
+// One Welford accumulator per class and feature (NaN cells skipped per feature). Partials
+// gathered over disjoint rows merge exactly (Chan), so threads, batches and shards can
+// be combined in any grouping without keeping the rows.
+struct GaussianMoments {
+    vector<string> featureNames;
+    vector<string> classNames;  // first-seen order
+    unordered_map<string, int> classIndex;
+    vector<size_t> classRows;
+    vector<ColumnStats> stats;  // classes x features, row-major
+    size_t totalRows = 0;
+
+    int numClasses() const { return classNames.size(); }
+    int numFeatures() const { return featureNames.size(); }
+
+    void setFeatures(const vector<string>& names) {
+        *this = GaussianMoments();
+        featureNames = names;
+    }
+
+    // Id of a class label, adding a class the first time it is seen
+    int classId(const string& label) {
+        auto it = classIndex.find(label);
+        if (it != classIndex.end()) return it->second;
+        int id = classNames.size();
+        classIndex[label] = id;
+        classNames.push_back(label);
+        classRows.push_back(0);
+        stats.resize(stats.size() + featureNames.size());
+        return id;
+    }
+
+    ColumnStats& at(int c, int j) { return stats[(size_t)c * featureNames.size() + j]; }
+    const ColumnStats& at(int c, int j) const { return stats[(size_t)c * featureNames.size() + j]; }
+
+    // Same features and classes, no rows (a per-thread partial)
+    GaussianMoments emptyLike() const {
+        GaussianMoments m;
+        m.featureNames = featureNames;
+        m.classNames = classNames;
+        m.classIndex = classIndex;
+        m.classRows.assign(classNames.size(), 0);
+        m.stats.assign(stats.size(), ColumnStats());
+        return m;
+    }
+
+    // --- Rows [begin, end) of the feature columns; ids[r] is the row's class ---
+    void addColumns(const double* const* cols, const int* ids, size_t begin, size_t end) {
+        for (size_t r = begin; r < end; r++) classRows[ids[r]]++;
+        for (int j = 0; j < numFeatures(); j++) {
+            const double* x = cols[j];
+            for (size_t r = begin; r < end; r++)
+                if (!std::isnan(x[r])) at(ids[r], j).add(x[r]);
+        }
+        totalRows += end - begin;
+    }
+
+    bool merge(const GaussianMoments& o) {
+        if (o.featureNames != featureNames) {
+            cerr << "Error: Cannot merge Gaussian Naive Bayes moments over different features." << endl;
+            return false;
+        }
+        for (int c = 0; c < o.numClasses(); c++) {
+            int k = classId(o.classNames[c]);
+            classRows[k] += o.classRows[c];
+            for (int j = 0; j < numFeatures(); j++) at(k, j).merge(o.at(c, j));
+        }
+        totalRows += o.totalRows;
+        return true;
+    }
+};
+
 class GaussianNaiveBayes {
 public:
+    // --- Output of predictBatch ---
+    struct BatchResult {
+        vector<int> predicted;      // index into classLabels per row
+        vector<double> posteriors;  // rows x classes, normalised (when requested)
+        long long labelled = 0;     // rows whose target column holds a known class
+        long long correct = 0;
+
+        double accuracy() const { return labelled ? (double)correct / labelled : 0.0; }
+    };
+
     vector<string> classLabels;
-    unordered_map<string, vector<vector<double>>> separatedData;
     unordered_map<string, vector<double>> means;
     unordered_map<string, vector<double>> variances;
     unordered_map<string, double> classPrior;
 
-    // --- Fit the model ---
-    void fit(const Dataset& data, const string& targetCol) {
-        int targetIndex = data.getColumnIndex(targetCol);
+private:
+    GaussianMoments moments;  // everything the model is trained from
+    string targetName;
+    CompiledGaussianNB model;
+    set<string> warned;       // non-numeric feature columns already reported
+    bool trained = false;
+    int numThreads = 0;               // 0 = hardware concurrency
+    static constexpr size_t BLOCK = 4096; // rows per parallel work item
+    static constexpr size_t CHUNK = 256;  // rows scored together inside a block
+
+    // Class id of every row via lookup(label) (-1 = not a known class). Labels are the raw
+    // cell text when the rows are loaded (so "1.50" stays "1.50"); column-only data falls
+    // back to the typed column.
+    template <class F>
+    static vector<int> labelIds(const Dataset& data, int target, F lookup) {
+        const Column& col = data.columnar().cols[target];
+        size_t n = data.columnar().nRows;
+        vector<int> ids(n, -1);
+        if (!data.rows.empty()) {
+            static const string empty;
+            for (size_t r = 0; r < n; r++)
+                ids[r] = lookup(target < (int)data.rows[r].size() ? data.rows[r][target] : empty);
+        } else if (col.type == COL_CATEGORICAL) {
+            const vector<string>& dict = col.dictionary();
+            vector<int> byCode(dict.size());
+            for (size_t k = 0; k < dict.size(); k++) byCode[k] = lookup(dict[k]);
+            const int32_t* codes = col.codeData();
+            for (size_t r = 0; r < n; r++) ids[r] = byCode[codes[r]];
+        } else {
+            for (size_t r = 0; r < n; r++) ids[r] = lookup(col.cell(r));
+        }
+        return ids;
+    }
+
+    // Feature columns of data in model order (false when one is missing)
+    bool featureColumns(const Dataset& data, vector<const double*>& cols) const {
+        const ColumnStore& cs = data.columnar();
+        cols.clear();
+        for (auto& name : moments.featureNames) {
+            int idx = data.getColumnIndex(name);
+            if (idx == -1) {
+                cerr << "Error: Feature column '" << name << "' not found." << endl;
+                return false;
+            }
+            cols.push_back(cs.numeric(idx).ptr);  // fills caches before any threads start
+        }
+        return true;
+    }
+
+    // --- Add a batch to the moments; per-thread partials over row ranges, merged in order ---
+    bool accumulate(const Dataset& batch, const string& targetCol) {
+        int targetIndex = batch.getColumnIndex(targetCol);
         if (targetIndex == -1) {
             cerr << "Target column not found!\n";
-            return;
-        }
-
-        // Separate rows by class
-        for (auto& row : data.rows) {
-            if (row.size() != data.headers.size()) continue;
-            string classValue = row[targetIndex];
-            vector<double> features;
-            for (int i = 0; i < (int)row.size(); i++) {
-                if (i == targetIndex) continue;
-                try {
-                    features.push_back(stod(row[i]));
-                } catch (...) {
-                    features.push_back(0.0);
-                }
-            }
-            separatedData[classValue].push_back(features);
+            return false;
+        }
+        if (moments.totalRows == 0 && moments.numClasses() == 0) {
+            vector<string> names;
+            for (int i = 0; i < (int)batch.headers.size(); i++)
+                if (i != targetIndex) names.push_back(batch.headers[i]);
+            moments.setFeatures(names);
+            targetName = targetCol;
+        } else if (targetCol != targetName) {
+            cerr << "Error: Model was trained on target column '" << targetName << "'." << endl;
+            return false;
         }
 
-        // Compute class labels
-        for (auto& kv : separatedData)
-            classLabels.push_back(kv.first);
+        vector<const double*> cols;
+        if (!featureColumns(batch, cols)) return false;
+        const ColumnStore& cs = batch.columnar();
+        for (auto& name : moments.featureNames)
+            if (cs.cols[batch.getColumnIndex(name)].type == COL_CATEGORICAL && warned.insert(name).second)
+                cerr << "Warning: Feature column '" << name << "' has non-numeric cells (treated as missing)." << endl;
+        size_t n = cs.nRows;
+        vector<int> ids = labelIds(batch, targetIndex, [&](const string& label) { return moments.classId(label); });
 
-        // Compute mean and variance for each feature of each class
-        for (auto& label : classLabels) {
-            int n_features = separatedData[label][0].size();
-            vector<double> mean(n_features, 0.0);
-            vector<double> var(n_features, 0.0);
+        int T = Parallel::resolveThreads(numThreads, max<size_t>(1, n / BLOCK));
+        vector<GaussianMoments> partials(T, moments.emptyLike());
+        Parallel::forRange(n, T, [&](size_t b, size_t e, int t) { partials[t].addColumns(cols.data(), ids.data(), b, e); });
+        for (auto& part : partials) moments.merge(part);
+        return true;
+    }
 
-            // Mean
-            for (auto& row : separatedData[label])
-                for (int j = 0; j < n_features; j++)
-                    mean[j] += row[j];
-            for (double& m : mean)
-                m /= separatedData[label].size();
+    // Means, sample variances and priors from the moments, then compile the tables
+    void finishTraining(bool verbose) {
+        int C = moments.numClasses(), d = moments.numFeatures();
+        classLabels = moments.classNames;
+        means.clear();
+        variances.clear();
+        classPrior.clear();
+        vector<double> priors(C), mu((size_t)C * d), var((size_t)C * d);
+        for (int c = 0; c < C; c++) {
+            const string& label = classLabels[c];
+            priors[c] = (double)moments.classRows[c] / moments.totalRows;
+            for (int j = 0; j < d; j++) {
+                const ColumnStats& st = moments.at(c, j);
+                mu[(size_t)c * d + j] = st.count ? st.mean : NAN;
+                var[(size_t)c * d + j] = st.count > 1 ? st.m2 / (st.count - 1) : NAN;
+            }
+            means[label].assign(mu.begin() + (size_t)c * d, mu.begin() + (size_t)(c + 1) * d);
+            variances[label].assign(var.begin() + (size_t)c * d, var.begin() + (size_t)(c + 1) * d);
+            classPrior[label] = priors[c];
+        }
+        model.build(C, d, priors.data(), mu.data(), var.data());
+        trained = C > 0;
+        if (verbose) cout << "Model trained successfully with " << classLabels.size() << " classes.\n";
+    }
 
-            // Variance
-            for (auto& row : separatedData[label])
-                for (int j = 0; j < n_features; j++)
-                    var[j] += pow(row[j] - mean[j], 2);
-            for (double& v : var)
-                v /= (separatedData[label].size() - 1);
+    // Score rows [0, n) of the given feature columns on worker threads
+    void scoreBatch(const vector<const double*>& cols, size_t n, const int* actual, bool withPosteriors,
+                    BatchResult& res) const {
+        int C = model.numClasses;
+        res.predicted.resize(n);
+        if (withPosteriors) res.posteriors.resize(n * C);
 
-            means[label] = mean;
-            variances[label] = var;
-            classPrior[label] = (double)separatedData[label].size() / data.rows.size();
+        int T = Parallel::resolveThreads(numThreads, max<size_t>(1, (n + BLOCK - 1) / BLOCK));
+        vector<long long> labelled(T, 0), correct(T, 0);
+        Parallel::forBlocks(n, BLOCK, T, [&](size_t b, size_t e, int t) {
+            vector<double> scores(CHUNK * C);
+            for (size_t c0 = b; c0 < e; c0 += CHUNK) {
+                size_t c1 = min(e, c0 + CHUNK);
+                model.scoreColumns(cols.data(), c0, c1, scores.data());
+                for (size_t i = c0; i < c1; i++) {
+                    const double* s = &scores[(i - c0) * C];
+                    int k = model.argmax(s);
+                    res.predicted[i] = k;
+                    if (withPosteriors) model.normalize(s, &res.posteriors[i * C]);
+                    if (actual && actual[i] >= 0) {
+                        labelled[t]++;
+                        correct[t] += actual[i] == k;
+                    }
+                }
+            }
+        });
+        for (int t = 0; t < T; t++) {
+            res.labelled += labelled[t];
+            res.correct += correct[t];
         }
+    }
+
+public:
+    void setThreads(int threads) { numThreads = threads; }
+    const CompiledGaussianNB& compiled() const { return model; }
 
-        cout << "Model trained successfully with " << classLabels.size() << " classes.\n";
+    // --- Fit the model (one pass, Welford moments per class) ---
+    void fit(const Dataset& data, const string& targetCol) {
+        moments = GaussianMoments();
+        warned.clear();
+        trained = false;
+        if (accumulate(data, targetCol)) finishTraining(true);
+    }
+
+    // --- Fit from a stream of batches; only the per-class moments are kept ---
+    void fit(DatasetStream& stream, const string& targetCol, bool verbose = true) {
+        moments = GaussianMoments();
+        warned.clear();
+        trained = false;
+        Dataset batch;
+        stream.reset();
+        while (stream.next(batch))
+            if (!accumulate(batch, targetCol)) return;
+        finishTraining(verbose);
     }
 
-    // --- Gaussian Probability Density Function ---
-    double gaussian(double x, double mean, double var) {
-        double eps = 1e-9;
-        double coeff = 1.0 / sqrt(2.0 * M_PI * (var + eps));
-        double expPart = exp(-pow(x - mean, 2) / (2 * (var + eps)));
-        return coeff * expPart;
+    // --- Add a batch of labelled rows to a trained (or empty) model ---
+    // The first batch fixes the feature columns; later batches are matched by name.
+    void partialFit(const Dataset& batch, const string& targetCol, bool verbose = false) {
+        if (accumulate(batch, targetCol)) finishTraining(verbose);
+    }
+
+    // --- Combine with a model trained on other rows (e.g. another shard); exact ---
+    bool merge(const GaussianNaiveBayes& other) {
+        if (moments.totalRows == 0) {
+            moments = other.moments;
+            targetName = other.targetName;
+        } else if (other.targetName != targetName) {
+            cerr << "Error: Cannot merge models with different target columns." << endl;
+            return false;
+        } else if (!moments.merge(other.moments)) {
+            return false;
+        }
+        finishTraining(false);
+        return true;
     }
 
-    // --- Predict single instance ---
+    // --- Predict single instance (log space, compiled tables) ---
     string predict(const vector<double>& features) {
-        double bestProb = -1.0;
-        string bestClass = "";
-
-        for (auto& label : classLabels) {
-            double prob = log(classPrior[label] + 1e-9);
-            for (int j = 0; j < (int)features.size(); j++) {
-                double mean = means[label][j];
-                double var = variances[label][j];
-                double pdf = gaussian(features[j], mean, var);
-                prob += log(pdf + 1e-9);
-            }
+        if (!trained) {
+            cerr << "Error: Model not trained yet." << endl;
+            return "";
+        }
+        if ((int)features.size() != model.numFeatures) {
+            cerr << "Error: Expected " << model.numFeatures << " features, got " << features.size() << "." << endl;
+            return "";
+        }
+        vector<double> scores(model.numClasses);
+        return classLabels[model.scoreRow(features.data(), scores.data())];
+    }
 
-            if (prob > bestProb) {
-                bestProb = prob;
-                bestClass = label;
-            }
+    // --- Score a whole dataset in parallel ---
+    // Feature columns are matched by header name; when the target column is present,
+    // accuracy is counted in the same pass.
+    BatchResult predictBatch(const Dataset& data, bool withPosteriors = false) const {
+        BatchResult res;
+        if (!trained) {
+            cerr << "Error: Model not trained yet." << endl;
+            return res;
+        }
+        vector<const double*> cols;
+        if (!featureColumns(data, cols)) return res;
+        const ColumnStore& cs = data.columnar();
+        int target = data.getColumnIndex(targetName);
+        vector<int> actual;
+        if (target != -1) {
+            const unordered_map<string, int>& index = moments.classIndex;
+            actual = labelIds(data, target, [&](const string& label) {
+                auto it = index.find(label);
+                return it == index.end() ? -1 : it->second;
+            });
         }
-        return bestClass;
+        scoreBatch(cols, cs.nRows, actual.empty() ? nullptr : actual.data(), withPosteriors, res);
+        return res;
+    }
+
+    // --- Score rows x numFeatures row-major values in parallel ---
+    BatchResult predictBatch(const double* X, size_t rows, bool withPosteriors = false) const {
+        BatchResult res;
+        if (!trained) {
+            cerr << "Error: Model not trained yet." << endl;
+            return res;
+        }
+        // The kernel reads columns, so transpose once up front
+        int d = model.numFeatures;
+        vector<double> xt((size_t)d * rows);
+        for (size_t i = 0; i < rows; i++)
+            for (int j = 0; j < d; j++) xt[(size_t)j * rows + i] = X[i * d + j];
+        vector<const double*> cols(d);
+        for (int j = 0; j < d; j++) cols[j] = xt.data() + (size_t)j * rows;
+        scoreBatch(cols, rows, nullptr, withPosteriors, res);
+        return res;
     }
 
     // --- Predict for multiple rows ---
     vector<string> predict(const Dataset& data) {
         vector<string> preds;
-        for (auto& row : data.rows) {
-            vector<double> features;
-            for (auto& val : row) {
-                try {
-                    features.push_back(stod(val));
-                } catch (...) {
-                    features.push_back(0.0);
-                }
-            }
-            preds.push_back(predict(features));
-        }
+        BatchResult res = predictBatch(data);
+        preds.reserve(res.predicted.size());
+        for (int k : res.predicted) preds.push_back(classLabels[k]);
         return preds;
     }
 
     // --- Verbose summary ---
     void printModelSummary() const {
         cout << "\n===== Gaussian Naive Bayes Model Summary =====\n";
-        for (auto& label : classLabels) {
+        for (size_t c = 0; c < classLabels.size(); c++) {
+            const string& label = classLabels[c];
             cout << "Class: " << label
-                 << " | Samples: " << separatedData.at(label).size()
+                 << " | Samples: " << moments.classRows[c]
                  << " | Prior: " << classPrior.at(label) << "\n";
             cout << "  Mean: ";
             for (double m : means.at(label)) cout << m << " ";
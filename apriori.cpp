@@ -9,10 +9,17 @@ private:
 
     // Support count map
     map<set<string>, int> supportCount;
+    int totalTransactions = 0;
 
 public:
+    Apriori(double s, double c = 0.7) {
+        minSupport = s;
+        minConfidence = c;
+    }
+
     Apriori(Dataset d, double s = 0.3, double c = 0.7) {
         data = d;
+        data.materializeRows();
         minSupport = s;
         minConfidence = c;
     }
@@ -29,6 +36,26 @@ public:
         return count;
     }
 
+    // Count support of every candidate in one pass over the stream
+    vector<int> countSupport(DatasetStream& stream, const vector<set<string>>& candidates) {
+        vector<int> counts(candidates.size(), 0);
+        Dataset batch;
+        set<string> transaction;
+
+        stream.reset();
+        while (stream.next(batch)) {
+            for (auto& row : batch.rows) {
+                transaction.clear();
+                transaction.insert(row.begin(), row.end());
+                for (size_t c = 0; c < candidates.size(); c++)
+                    if (includes(transaction.begin(), transaction.end(),
+                                 candidates[c].begin(), candidates[c].end()))
+                        counts[c]++;
+            }
+        }
+        return counts;
+    }
+
     // Generate candidate k-itemsets from L(k-1)
     vector<set<string>> generateCandidates(const vector<set<string>>& prevL) {
         vector<set<string>> candidates;
@@ -51,9 +78,18 @@ public:
 
     // Filter candidates by min support
     vector<set<string>> filterBySupport(const vector<set<string>>& candidates, int totalTransactions, bool verbose) {
+        vector<int> counts;
+        for (auto& itemset : candidates)
+            counts.push_back(countSupport(itemset));
+        return filterBySupport(candidates, counts, totalTransactions, verbose);
+    }
+
+    vector<set<string>> filterBySupport(const vector<set<string>>& candidates, const vector<int>& counts,
+                                        int totalTransactions, bool verbose) {
         vector<set<string>> L;
-        for (auto& itemset : candidates) {
-            int count = countSupport(itemset);
+        for (size_t c = 0; c < candidates.size(); c++) {
+            const set<string>& itemset = candidates[c];
+            int count = counts[c];
             double support = (double)count / totalTransactions;
             if (support >= minSupport) {
                 L.push_back(itemset);
@@ -70,7 +106,8 @@ public:
 
     // Generate all frequent itemsets
     vector<vector<set<string>>> generateFrequentItemsets(bool verbose = true) {
-        int totalTransactions = data.rows.size();
+        supportCount.clear();  // counts from an earlier run would leak into the rules
+        totalTransactions = data.rows.size();
         vector<vector<set<string>>> L_all;
 
         // Step 1: Generate 1-itemsets
@@ -103,6 +140,49 @@ public:
         return L_all;
     }
 
+    // Same as above over a stream: one pass for L1, then one pass per level
+    vector<vector<set<string>>> generateFrequentItemsets(DatasetStream& stream, bool verbose = true) {
+        supportCount.clear();
+        vector<vector<set<string>>> L_all;
+
+        // Step 1: Count single items and transactions together
+        map<string, int> itemCounts;
+        Dataset batch;
+        totalTransactions = 0;
+        stream.reset();
+        while (stream.next(batch)) {
+            totalTransactions += batch.rows.size();
+            for (auto& row : batch.rows) {
+                set<string> transaction(row.begin(), row.end());
+                for (auto& item : transaction) itemCounts[item]++;
+            }
+        }
+
+        vector<set<string>> C1;
+        vector<int> C1Counts;
+        for (auto& ic : itemCounts) {
+            C1.push_back({ic.first});
+            C1Counts.push_back(ic.second);
+        }
+
+        if (verbose) cout << "\n--- Generating L1 ---\n";
+        vector<set<string>> prevL = filterBySupport(C1, C1Counts, totalTransactions, verbose);
+        L_all.push_back(prevL);
+        int k = 2;
+
+        while (!prevL.empty()) {
+            if (verbose) cout << "\n--- Generating L" << k << " ---\n";
+            vector<set<string>> Ck = generateCandidates(prevL);
+            vector<set<string>> Lk = filterBySupport(Ck, countSupport(stream, Ck), totalTransactions, verbose);
+            if (Lk.empty()) break;
+            L_all.push_back(Lk);
+            prevL = Lk;
+            k++;
+        }
+
+        return L_all;
+    }
+
     // Generate and print association rules
     void generateRules(bool verbose = true) {
         if (verbose)
@@ -126,11 +206,13 @@ public:
                         consequent.insert(items[j]);
                 }
 
-                int supportAntecedent = countSupport(antecedent);
+                // Every subset of a frequent itemset is frequent, so its count is already known
+                auto known = supportCount.find(antecedent);
+                int supportAntecedent = known != supportCount.end() ? known->second : countSupport(antecedent);
                 double confidence = (double)totalSupport / supportAntecedent;
 
                 if (confidence >= minConfidence) {
-                    double support = (double)totalSupport / data.rows.size();
+                    double support = (double)totalSupport / totalTransactions;
                     cout << "{ ";
                     for (auto& a : antecedent) cout << a << " ";
                     cout << "} -> { ";
@@ -151,4 +233,14 @@ public:
         generateFrequentItemsets(verbose);
         generateRules(verbose);
     }
+
+    void run(DatasetStream& stream, bool verbose = true) {
+        if (verbose)
+            cout << "\n=== Running Apriori Algorithm (streamed) ===\n"
+                 << "Minimum Support: " << minSupport << "\n"
+                 << "Minimum Confidence: " << minConfidence << "\n";
+
+        generateFrequentItemsets(stream, verbose);
+        generateRules(verbose);
+    }
 };
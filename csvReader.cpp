@@ -0,0 +1,377 @@
+#include <bits/stdc++.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+using namespace std;
+
+// --- Read-only memory-mapped file ---
+class MappedFile {
+public:
+    const char* data = nullptr;
+    size_t size = 0;
+
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const string& filename, int advice = MADV_SEQUENTIAL) {
+        close();
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close();
+            return false;
+        }
+        size = st.st_size;
+        if (size == 0) return true;
+
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close();
+            return false;
+        }
+        madvise(p, size, advice);
+        data = (const char*)p;
+        return true;
+    }
+
+    void close() {
+        if (data) munmap((void*)data, size);
+        if (fd >= 0) ::close(fd);
+        data = nullptr;
+        size = 0;
+        fd = -1;
+    }
+
+private:
+    int fd = -1;
+};
+
+// --- Delimiter / quote scanning (SSE2 with scalar fallback) ---
+class CSVScanner {
+public:
+    // First position in [p, end) holding delim, '\n' or '\r' (end if none)
+    static const char* findFieldEnd(const char* p, const char* end, char delim) {
+#if defined(__SSE2__)
+        const __m128i vd = _mm_set1_epi8(delim);
+        const __m128i vn = _mm_set1_epi8('\n');
+        const __m128i vr = _mm_set1_epi8('\r');
+        while (end - p >= 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(chunk, vd),
+                          _mm_or_si128(_mm_cmpeq_epi8(chunk, vn), _mm_cmpeq_epi8(chunk, vr)));
+            int mask = _mm_movemask_epi8(hit);
+            if (mask) return p + __builtin_ctz(mask);
+            p += 16;
+        }
+#endif
+        while (p < end && *p != delim && *p != '\n' && *p != '\r') p++;
+        return p;
+    }
+
+    static size_t countQuotes(const char* p, const char* end) {
+        size_t count = 0;
+#if defined(__SSE2__)
+        const __m128i vq = _mm_set1_epi8('"');
+        while (end - p >= 16) {
+            __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+            count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, vq)));
+            p += 16;
+        }
+#endif
+        for (; p < end; p++) count += (*p == '"');
+        return count;
+    }
+
+    // Start of the first record after pos, given whether pos lies inside a quoted field
+    static const char* nextRecordStart(const char* p, const char* end, bool inQuote) {
+        for (; p < end; p++) {
+            if (*p == '"') inQuote = !inQuote;
+            else if (*p == '\n' && !inQuote) return p + 1;
+        }
+        return end;
+    }
+};
+
+// --- Parallel CSV loader writing straight into typed columns ---
+class CSVReader {
+public:
+    char delimiter = ',';
+    int numThreads = 0;  // 0 = hardware concurrency
+    bool verbose = true;
+
+    Dataset read(const string& filename, bool hasHeader = true) {
+        Dataset data;
+        auto t0 = chrono::steady_clock::now();
+
+        MappedFile file;
+        if (!file.open(filename)) {
+            cerr << "Error: Could not open file " << filename << endl;
+            return data;
+        }
+
+        const char* begin = file.data;
+        const char* end = file.data + file.size;
+
+        // Header (or first record, to learn the column count)
+        vector<string> first;
+        const char* body = parseRecord(begin, end, first);
+        size_t nCols = first.size();
+        if (hasHeader) {
+            data.headers = first;
+        } else {
+            body = begin;
+            for (size_t i = 0; i < nCols; i++)
+                data.headers.push_back("Column" + to_string(i + 1));
+        }
+
+        // Split the body into newline-aligned chunks, quote-aware
+        vector<const char*> bounds = splitChunks(body, end);
+        size_t nChunks = bounds.size() - 1;
+
+        vector<Chunk> chunks(nChunks);
+        Parallel::forRange(nChunks, (int)nChunks, [&](size_t b, size_t e, int) {
+            for (size_t c = b; c < e; c++)
+                parseChunk(bounds[c], bounds[c + 1], nCols, chunks[c]);
+        });
+
+        data.setColumns(mergeChunks(chunks, nCols));
+
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        lastSeconds = secs;
+        lastMBps = secs > 0 ? file.size / 1e6 / secs : 0;
+
+        if (verbose) {
+            ostringstream ss;
+            ss << fixed << setprecision(1) << file.size / 1e6 << " MB in " << secs * 1000
+               << " ms, " << lastMBps << " MB/s";
+            cout << "Loaded dataset: " << data.size() << " rows, " << data.headers.size()
+                 << " columns (" << ss.str() << ", " << nChunks << " threads)\n";
+        }
+        return data;
+    }
+
+    double lastSeconds = 0;
+    double lastMBps = 0;
+
+private:
+    struct ChunkColumn {
+        vector<string_view> cells;   // raw (trimmed/unescaped) text, for categorical columns
+        vector<double> nums;         // filled while every cell parses as a double
+        vector<int64_t> ints;        // filled while every cell parses as an integer
+        bool allInt = true, allNum = true, anyValue = false;
+    };
+
+    struct Chunk {
+        vector<ChunkColumn> cols;
+        deque<string> unescaped;     // owns text of quoted fields containing ""
+        size_t nRows = 0;
+    };
+
+    static string_view trimView(const char* b, const char* e) {
+        while (b < e && isspace((unsigned char)*b)) b++;
+        while (e > b && isspace((unsigned char)e[-1])) e--;
+        return string_view(b, e - b);
+    }
+
+    // Parse one field starting at p; returns the position of the terminator
+    const char* parseField(const char* p, const char* end, string_view& out, deque<string>& owned) {
+        const char* s = p;
+        while (s < end && (*s == ' ' || *s == '\t')) s++;
+
+        if (s < end && *s == '"') {
+            const char* q = s + 1;
+            const char* start = q;
+            string* buf = nullptr;
+            while (true) {
+                const char* close = (const char*)memchr(q, '"', end - q);
+                if (!close) close = end;
+                if (close + 1 < end && close[1] == '"') {
+                    if (!buf) { owned.emplace_back(); buf = &owned.back(); }
+                    buf->append(q, close + 1);   // keep one quote
+                    q = close + 2;
+                    continue;
+                }
+                if (buf) {
+                    buf->append(q, close);
+                    out = string_view(*buf);
+                } else {
+                    out = string_view(start, close - start);
+                }
+                p = close < end ? close + 1 : end;
+                break;
+            }
+            // Anything between the closing quote and the delimiter is ignored
+            return findFieldEnd(p, end);
+        }
+
+        const char* e = findFieldEnd(p, end);
+        out = trimView(p, e);
+        return e;
+    }
+
+    const char* findFieldEnd(const char* p, const char* end) const {
+        return CSVScanner::findFieldEnd(p, end, delimiter);
+    }
+
+    static const char* skipLineEnd(const char* p, const char* end) {
+        if (p < end && *p == '\r') p++;
+        if (p < end && *p == '\n') p++;
+        return p;
+    }
+
+    // Header / first record as owned strings
+    const char* parseRecord(const char* p, const char* end, vector<string>& fields) {
+        deque<string> owned;
+        while (p < end && (*p == '\n' || *p == '\r')) p++;
+        while (p < end) {
+            string_view f;
+            p = parseField(p, end, f, owned);
+            fields.emplace_back(f);
+            if (p < end && *p == delimiter) { p++; continue; }
+            return skipLineEnd(p, end);
+        }
+        return p;
+    }
+
+    vector<const char*> splitChunks(const char* begin, const char* end) {
+        size_t bytes = end - begin;
+        int n = Parallel::resolveThreads(numThreads, max<size_t>(1, bytes / (1 << 20)));
+
+        vector<const char*> raw(n + 1);
+        for (int t = 0; t <= n; t++) raw[t] = begin + bytes * t / n;
+
+        // Quote parity at each raw split point tells whether it falls inside a quoted field
+        vector<size_t> quotes(n);
+        Parallel::forRange(n, n, [&](size_t b, size_t e, int) {
+            for (size_t t = b; t < e; t++)
+                quotes[t] = CSVScanner::countQuotes(raw[t], raw[t + 1]);
+        });
+
+        // (assumes RFC-4180: quotes only appear around / escaped inside quoted fields)
+        vector<const char*> bounds = {begin};
+        size_t parity = 0;
+        for (int t = 1; t < n; t++) {
+            parity += quotes[t - 1];
+            const char* b = CSVScanner::nextRecordStart(raw[t], end, parity & 1);
+            if (b > bounds.back() && b < end) bounds.push_back(b);
+        }
+        bounds.push_back(end);
+        return bounds;
+    }
+
+    void addCell(ChunkColumn& c, string_view v) {
+        c.cells.push_back(v);
+        if (v.empty()) {
+            c.allInt = false;
+            if (c.allNum) c.nums.push_back(NAN);
+            return;
+        }
+        c.anyValue = true;
+
+        const char* b = v.data();
+        const char* e = b + v.size();
+        if (*b == '+' && e - b > 1) b++;
+
+        if (c.allInt) {
+            int64_t x;
+            auto r = from_chars(b, e, x);
+            if (r.ec == errc() && r.ptr == e) c.ints.push_back(x);
+            else { c.allInt = false; vector<int64_t>().swap(c.ints); }
+        }
+        if (c.allNum) {
+            double x;
+            auto r = from_chars(b, e, x);
+            if (r.ec == errc() && r.ptr == e) c.nums.push_back(x);
+            else { c.allNum = false; vector<double>().swap(c.nums); }
+        }
+    }
+
+    void parseChunk(const char* p, const char* end, size_t nCols, Chunk& chunk) {
+        chunk.cols.assign(nCols, ChunkColumn());
+        size_t estRows = (end - p) / max<size_t>(1, nCols * 4);
+        for (auto& c : chunk.cols) c.cells.reserve(estRows);
+
+        while (p < end) {
+            if (*p == '\n' || *p == '\r') { p = skipLineEnd(p, end); continue; }  // empty line
+
+            size_t col = 0;
+            while (true) {
+                string_view f;
+                p = parseField(p, end, f, chunk.unescaped);
+                if (col < nCols) addCell(chunk.cols[col], f);
+                col++;
+                if (p < end && *p == delimiter) { p++; continue; }
+                p = skipLineEnd(p, end);
+                break;
+            }
+            for (; col < nCols; col++) addCell(chunk.cols[col], string_view());
+            chunk.nRows++;
+        }
+    }
+
+    ColumnStore mergeChunks(vector<Chunk>& chunks, size_t nCols) {
+        ColumnStore cs;
+        cs.cols.assign(nCols, Column());
+        for (auto& ch : chunks) cs.nRows += ch.nRows;
+
+        Parallel::forRange(nCols, numThreads, [&](size_t b, size_t e, int) {
+            for (size_t j = b; j < e; j++) {
+                bool allInt = true, allNum = true, anyValue = false;
+                for (auto& ch : chunks) {
+                    allInt &= ch.cols[j].allInt;
+                    allNum &= ch.cols[j].allNum;
+                    anyValue |= ch.cols[j].anyValue;
+                }
+
+                Column& col = cs.cols[j];
+                if (!anyValue || !allNum) col.type = COL_CATEGORICAL;
+                else col.type = allInt ? COL_INTEGER : COL_NUMERIC;
+
+                if (col.type == COL_INTEGER) {
+                    col.ints.reserve(cs.nRows);
+                    for (auto& ch : chunks)
+                        col.ints.insert(col.ints.end(), ch.cols[j].ints.begin(), ch.cols[j].ints.end());
+                } else if (col.type == COL_NUMERIC) {
+                    col.values.reserve(cs.nRows);
+                    for (auto& ch : chunks)
+                        col.values.insert(col.values.end(), ch.cols[j].nums.begin(), ch.cols[j].nums.end());
+                } else {
+                    unordered_map<string_view, int32_t> ids;
+                    col.codes.reserve(cs.nRows);
+                    for (auto& ch : chunks) {
+                        for (auto& v : ch.cols[j].cells) {
+                            auto it = ids.find(v);
+                            if (it == ids.end()) {
+                                it = ids.emplace(v, (int32_t)col.dict.size()).first;
+                                col.dict.emplace_back(v);
+                            }
+                            col.codes.push_back(it->second);
+                        }
+                    }
+                }
+
+                for (auto& ch : chunks) {
+                    vector<string_view>().swap(ch.cols[j].cells);
+                    vector<double>().swap(ch.cols[j].nums);
+                    vector<int64_t>().swap(ch.cols[j].ints);
+                }
+            }
+        });
+        return cs;
+    }
+};
+
+// --- Convenience wrapper matching readCSV ---
+Dataset readCSVFast(const string& filename, bool hasHeader = true, int numThreads = 0) {
+    CSVReader reader;
+    reader.numThreads = numThreads;
+    return reader.read(filename, hasHeader);
+}
@@ -0,0 +1,132 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// --- Reads a CSV file in fixed-size row batches (bounded memory) ---
+class DatasetStream {
+public:
+    vector<string> headers;
+    size_t batchRows;
+
+    DatasetStream(const string& fname, size_t batchSize = 65536, bool hasHeader = true)
+        : batchRows(max<size_t>(1, batchSize)), filename(fname) {
+        file.open(filename);
+        if (!file.is_open()) {
+            cerr << "Error: Could not open file " << filename << endl;
+            return;
+        }
+
+        vector<string> first;
+        string line;
+        streampos start = file.tellg();
+        while (readRecord(line, first) && first.size() == 1 && first[0].empty())
+            start = file.tellg();  // skip leading empty lines
+
+        if (hasHeader) {
+            headers = first;
+            dataStart = file.tellg();
+        } else {
+            for (size_t i = 0; i < first.size(); i++)
+                headers.push_back("Column" + to_string(i + 1));
+            dataStart = start;
+            file.clear();
+            file.seekg(dataStart);
+        }
+    }
+
+    bool isOpen() const { return file.is_open(); }
+
+    int getColumnIndex(const string& colName) const {
+        auto it = find(headers.begin(), headers.end(), colName);
+        return it == headers.end() ? -1 : (int)distance(headers.begin(), it);
+    }
+
+    // --- Fill batch with up to batchRows rows; false once the file is exhausted ---
+    bool next(Dataset& batch) {
+        batch.headers = headers;
+        if (!file.is_open()) {
+            batch.rows.clear();
+            return false;
+        }
+
+        // Row vectors are reused across batches to avoid reallocating every cell
+        if (batch.rows.size() < batchRows) batch.rows.resize(batchRows);
+        size_t n = 0;
+        string line;
+        while (n < batchRows && readRecord(line, batch.rows[n])) {
+            if (batch.rows[n].size() == 1 && batch.rows[n][0].empty()) continue;  // empty line
+            n++;
+        }
+        batch.rows.resize(n);
+        batch.invalidateColumns();
+        rowsSeen += n;
+        return n > 0;
+    }
+
+    // --- Rewind to the first data row for another pass ---
+    void reset() {
+        if (!file.is_open()) return;
+        file.clear();
+        file.seekg(dataStart);
+        rowsSeen = 0;
+    }
+
+    size_t rowsRead() const { return rowsSeen; }
+
+private:
+    string filename;
+    ifstream file;
+    streampos dataStart = 0;
+    size_t rowsSeen = 0;
+
+    // Next cell of out, reusing the existing string's buffer when there is one
+    static string& cellAt(vector<string>& out, size_t k) {
+        if (k == out.size()) out.emplace_back();
+        return out[k];
+    }
+
+    // One logical record (quoted fields may span lines); false at EOF
+    bool readRecord(string& line, vector<string>& out) {
+        if (!getline(file, line)) return false;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        // Keep appending physical lines while a quote is open
+        string more;
+        while (count(line.begin(), line.end(), '"') % 2 == 1 && getline(file, more)) {
+            if (!more.empty() && more.back() == '\r') more.pop_back();
+            line += "\n" + more;
+        }
+
+        size_t i = 0, k = 0, n = line.size();
+        while (true) {
+            string& cell = cellAt(out, k++);
+            size_t s = i;
+            while (s < n && (line[s] == ' ' || line[s] == '\t')) s++;
+
+            if (s < n && line[s] == '"') {
+                cell.clear();
+                size_t j = s + 1;
+                while (j < n) {
+                    if (line[j] == '"') {
+                        if (j + 1 < n && line[j + 1] == '"') { cell += '"'; j += 2; continue; }
+                        break;
+                    }
+                    cell += line[j++];
+                }
+                i = line.find(',', j);
+            } else {
+                size_t e = line.find(',', i);
+                if (e == string::npos) e = n;
+                size_t b = i;
+                while (b < e && isspace((unsigned char)line[b])) b++;
+                while (e > b && isspace((unsigned char)line[e - 1])) e--;
+                cell.assign(line, b, e - b);
+                i = line.find(',', i);
+            }
+
+            if (i == string::npos) break;
+            i++;
+        }
+        out.resize(k);
+        return true;
+    }
+};
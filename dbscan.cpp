@@ -3,70 +3,99 @@ using namespace std;
 
 class DBSCAN {
 private:
-    Dataset data;
     double eps;
     int minPts;
     int nRows, nCols;
 
-    vector<vector<double>> numericData;
+    vector<double> points;   // nRows x nCols, row-major
     vector<int> labels; // -1 = noise, 0 = unvisited, >0 = cluster id
+    NeighborIndex index;
+    const NeighborGraph* graph = nullptr;  // cached neighbours (replaces index when set)
+    int numThreads = 0;      // 0 = hardware concurrency
+    int clusterCount = 0;
+
+    void neighborsOf(int i, vector<int>& out) const {
+        if (graph) graph->neighbors(i, eps, out);
+        else index.query(i, eps, out);
+    }
+
+    size_t neighborCount(int i, vector<int>& scratch) const {
+        if (graph) return graph->degree(i, eps);
+        scratch.clear();
+        index.query(i, eps, scratch);
+        return scratch.size();
+    }
 
 public:
-    DBSCAN(Dataset d, double e, int m) {
-        data = d;
+    DBSCAN(const Dataset& d, double e, int m) {
         eps = e;
         minPts = m;
-        nRows = d.rows.size();
+        nRows = d.size();
         nCols = d.headers.size();
         labels.assign(nRows, 0);
 
         // Convert string dataset to numeric
-        numericData.resize(nRows, vector<double>(nCols));
-        for (int i = 0; i < nRows; i++) {
-            for (int j = 0; j < nCols; j++) {
-                try {
-                    numericData[i][j] = stod(d.rows[i][j]);
-                } catch (...) {
-                    numericData[i][j] = 0.0;
-                }
-            }
+        size_t missing = 0;
+        points = d.columnar().numericMatrix(&missing);
+        if (missing) cerr << "Warning: " << missing << " missing cells filled with column means." << endl;
+        index.build(points.data(), nRows, nCols, eps);
+    }
+
+    // --- Run from a prebuilt neighbour graph (eps must not exceed its radius) ---
+    DBSCAN(const NeighborGraph& g, double e, int m) : graph(&g) {
+        eps = e;
+        minPts = m;
+        nRows = g.size();
+        nCols = g.index().dims();
+        labels.assign(nRows, 0);
+        if (eps > g.maxRadius()) {
+            cerr << "Warning: eps " << eps << " exceeds the neighbor graph radius " << g.maxRadius()
+                 << "; using " << g.maxRadius() << endl;
+            eps = g.maxRadius();
+        }
+    }
+
+    // --- Pick the neighbour search (AUTO: grid for d <= 3, KD-tree up to 16, else brute) ---
+    void setIndex(NeighborIndex::Kind kind) {
+        if (graph) {
+            cerr << "Warning: DBSCAN uses a cached neighbor graph; index choice ignored." << endl;
+            return;
         }
+        index.build(points.data(), nRows, nCols, eps, kind);
     }
 
     double distance(int i, int j) {
-        double sum = 0.0;
-        for (int k = 0; k < nCols; k++)
-            sum += pow(numericData[i][k] - numericData[j][k], 2);
-        return sqrt(sum);
+        const NeighborIndex& ix = graph ? graph->index() : index;
+        if (!ix.row(i) || !ix.row(j)) return NAN;
+        return sqrt(ix.dist2(ix.row(i), ix.row(j)));
     }
 
     vector<int> regionQuery(int idx) {
         vector<int> neighbors;
-        for (int i = 0; i < nRows; i++) {
-            if (distance(idx, i) <= eps)
-                neighbors.push_back(i);
-        }
+        neighborsOf(idx, neighbors);
         return neighbors;
     }
 
-    void expandCluster(int idx, vector<int> neighbors, int clusterId, bool verbose) {
+    // Label a neighbour; unvisited points are queued once, noise becomes border
+    void claim(int n, int clusterId, queue<int>& q) {
+        if (labels[n] == -1) labels[n] = clusterId; // previously noise becomes part of cluster
+        if (labels[n] != 0) return;                 // already assigned
+        labels[n] = clusterId;
+        q.push(n);
+    }
+
+    void expandCluster(int idx, const vector<int>& neighbors, int clusterId, bool verbose) {
         labels[idx] = clusterId;
 
         queue<int> q;
-        for (int n : neighbors) q.push(n);
+        for (int n : neighbors) claim(n, clusterId, q);
 
+        vector<int> newNeighbors;
         while (!q.empty()) {
             int curr = q.front(); q.pop();
 
-            if (labels[curr] == -1)
-                labels[curr] = clusterId; // previously noise becomes part of cluster
-
-            if (labels[curr] != 0)
-                continue; // already assigned
-
-            labels[curr] = clusterId;
-
-            vector<int> newNeighbors = regionQuery(curr);
+            newNeighbors.clear();
+            neighborsOf(curr, newNeighbors);
             if (verbose) {
                 cout << "  Expanding point " << curr << " → found " 
                      << newNeighbors.size() << " neighbors\n";
@@ -74,18 +103,96 @@ public:
 
             if (newNeighbors.size() >= minPts) {
                 for (int n : newNeighbors)
-                    q.push(n);
+                    claim(n, clusterId, q);
             }
         }
     }
 
+    // --- Multi-threaded DBSCAN: core points, union-find over core pairs, then borders ---
+    // Clusters are numbered by their smallest core point and a border point joins the
+    // lowest-numbered adjacent cluster, which is exactly what runSequential() produces.
     void run(bool verbose = true) {
+        // The phases query each point up to twice; with one thread the BFS is cheaper
+        int threads = Parallel::resolveThreads(numThreads, nRows / 256 + 1);
+        if (threads == 1) {
+            runSequential(verbose);
+            return;
+        }
+
+        if (verbose) {
+            cout << "\n--- DBSCAN Clustering (parallel) ---\n";
+            cout << "Epsilon (eps): " << eps << "\n";
+            cout << "MinPts: " << minPts << "\n";
+            printNeighborSource();
+            cout << "--------------------------\n";
+        }
+        auto t0 = chrono::steady_clock::now();
+        const size_t BLOCK = 256;
+
+        // Phase 1: neighbour counts -> core flags
+        vector<char> core(nRows, 0);
+        Parallel::forBlocks(nRows, BLOCK, threads, [&](size_t b, size_t e, int) {
+            vector<int> nb;
+            for (size_t i = b; i < e; i++)
+                core[i] = neighborCount(i, nb) >= (size_t)minPts;
+        });
+
+        // Phase 2: union every pair of core points within eps
+        ConcurrentDisjointSet sets(nRows);
+        Parallel::forBlocks(nRows, BLOCK, threads, [&](size_t b, size_t e, int) {
+            vector<int> nb;
+            for (size_t i = b; i < e; i++) {
+                if (!core[i]) continue;
+                nb.clear();
+                neighborsOf(i, nb);
+                for (int j : nb)
+                    if (j < (int)i && core[j]) sets.unite(i, j);
+            }
+        });
+
+        // Cluster ids in order of each cluster's smallest core point
+        vector<int> clusterOf(nRows, 0);
         int clusterId = 0;
+        for (int i = 0; i < nRows; i++)
+            if (core[i] && sets.find(i) == i) clusterOf[i] = ++clusterId;
+
+        // Phase 3: core points take their root's id, others the lowest adjacent cluster
+        labels.assign(nRows, -1);
+        Parallel::forBlocks(nRows, BLOCK, threads, [&](size_t b, size_t e, int) {
+            vector<int> nb;
+            for (size_t i = b; i < e; i++) {
+                if (core[i]) {
+                    labels[i] = clusterOf[sets.find(i)];
+                    continue;
+                }
+                nb.clear();
+                neighborsOf(i, nb);
+                int best = INT_MAX;
+                for (int j : nb)
+                    if (core[j]) best = min(best, clusterOf[sets.find(j)]);
+                if (best != INT_MAX) labels[i] = best;
+            }
+        });
+
+        clusterCount = clusterId;
+        if (verbose) {
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            int coreCount = count(core.begin(), core.end(), 1);
+            cout << "Core points: " << coreCount << " (" << ms << " ms, " << threads << " threads)\n";
+            printSummary();
+        }
+    }
+
+    // --- Original single-threaded BFS expansion ---
+    void runSequential(bool verbose = true) {
+        int clusterId = 0;
+        labels.assign(nRows, 0);
 
         if (verbose) {
             cout << "\n--- DBSCAN Clustering ---\n";
             cout << "Epsilon (eps): " << eps << "\n";
             cout << "MinPts: " << minPts << "\n";
+            printNeighborSource();
             cout << "--------------------------\n";
         }
 
@@ -111,13 +218,56 @@ public:
             }
         }
 
+        clusterCount = clusterId;
+        if (verbose) printSummary();
+    }
+
+    void printNeighborSource() {
+        if (graph) cout << "Neighbor index: cached graph (radius " << graph->maxRadius() << ")\n";
+        else cout << "Neighbor index: " << NeighborIndex::kindName(index.type()) << "\n";
+    }
+
+    void printSummary() {
+        cout << "\nClustering Completed.\n";
+        int noiseCount = count(labels.begin(), labels.end(), -1);
+        cout << "Total clusters formed: " << clusterCount << endl;
+        cout << "Noise points: " << noiseCount << endl;
+        printClusters();
+    }
+
+    void setThreads(int threads) { numThreads = threads; }
+
+    int getClusterCount() const { return clusterCount; }
+
+    // --- Run every (eps, minPts) pair from one cached graph and tabulate the results ---
+    struct SweepResult {
+        double eps;
+        int minPts;
+        int clusters;
+        int noise;
+    };
+
+    static vector<SweepResult> sweep(const NeighborGraph& g, const vector<double>& epsValues,
+                                     const vector<int>& minPtsValues, int threads = 0, bool verbose = true) {
+        vector<SweepResult> results;
+        for (double e : epsValues) {
+            for (int m : minPtsValues) {
+                DBSCAN db(g, e, m);
+                db.setThreads(threads);
+                db.run(false);
+                int noise = count(db.labels.begin(), db.labels.end(), -1);
+                results.push_back({db.eps, m, db.clusterCount, noise});
+            }
+        }
+
         if (verbose) {
-            cout << "\nClustering Completed.\n";
-            int noiseCount = count(labels.begin(), labels.end(), -1);
-            cout << "Total clusters formed: " << clusterId << endl;
-            cout << "Noise points: " << noiseCount << endl;
-            printClusters();
+            cout << "\nDBSCAN sweep (" << g.size() << " rows, graph radius " << g.maxRadius() << ")\n";
+            cout << "---------------------------------------------\n";
+            cout << setw(10) << "eps" << setw(10) << "minPts" << setw(12) << "clusters" << setw(12) << "noise" << endl;
+            for (auto& r : results)
+                cout << setw(10) << r.eps << setw(10) << r.minPts << setw(12) << r.clusters << setw(12) << r.noise << endl;
         }
+        return results;
     }
 
     void printClusters() {
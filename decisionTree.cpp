@@ -18,6 +18,7 @@ private:
 public:
     DecisionTree(Dataset d) {
         data = d;
+        data.materializeRows();
         headers = d.headers;
         root = nullptr;
     }
@@ -0,0 +1,257 @@
+#include <bits/stdc++.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DISTANCE_X86 1
+#endif
+using namespace std;
+
+// --- Pairwise distances shared by the clustering code ---
+// distance() is the scalar reference. block() computes a rectangle of distances with
+// SIMD across 16 columns at a time (AVX-512 / AVX2 / scalar, chosen at runtime); it
+// uses the same per-pair operation order as distance() and no FMA, so both give
+// bit-identical values. forEachTile() streams tiles to a callback from worker threads,
+// and condensed() fills a scipy-style upper triangle.
+class DistanceKernel {
+public:
+    enum Metric { EUCLIDEAN, SQEUCLIDEAN, MANHATTAN, COSINE };
+    enum Isa { SCALAR, AVX2, AVX512 };
+
+    Metric metric;
+    Isa isa;
+    int numThreads;  // 0 = hardware concurrency
+
+    explicit DistanceKernel(Metric m = EUCLIDEAN, int threads = 0) : metric(m), isa(detect()), numThreads(threads) {}
+
+    static Isa detect() {
+#ifdef DISTANCE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return AVX512;
+        if (__builtin_cpu_supports("avx2")) return AVX2;
+#endif
+        return SCALAR;
+    }
+
+    static const char* metricName(Metric m) {
+        return m == EUCLIDEAN ? "euclidean" : m == SQEUCLIDEAN ? "sqeuclidean" : m == MANHATTAN ? "manhattan" : "cosine";
+    }
+
+    static double sqEuclidean(const double* a, const double* b, size_t d) {
+        double s = 0;
+        for (size_t k = 0; k < d; k++) {
+            double t = a[k] - b[k];
+            s += t * t;
+        }
+        return s;
+    }
+
+    static double distance(const double* a, const double* b, size_t d, Metric m) {
+        if (m == SQEUCLIDEAN) return sqEuclidean(a, b, d);
+        if (m == EUCLIDEAN) return sqrt(sqEuclidean(a, b, d));
+        if (m == MANHATTAN) {
+            double s = 0;
+            for (size_t k = 0; k < d; k++) s += fabs(a[k] - b[k]);
+            return s;
+        }
+        double dot = 0;
+        for (size_t k = 0; k < d; k++) dot += a[k] * b[k];
+        return cosineFrom(dot, selfDot(a, d), selfDot(b, d));
+    }
+
+    double operator()(const double* a, const double* b, size_t d) const { return distance(a, b, d, metric); }
+
+    // --- Distances between rows [i0, i1) of X and rows [j0, j1) of Y (both n x d) ---
+    // out[(i - i0) * ld + (j - j0)]; single-threaded, safe to call from several threads.
+    void block(const double* X, size_t i0, size_t i1, const double* Y, size_t j0, size_t j1, size_t d,
+               double* out, size_t ld) const {
+        alignas(64) double yT[MAX_D_STACK * W];
+        vector<double> heap;
+        double* yt = yT;
+        if (d > MAX_D_STACK) {
+            heap.resize(d * W);
+            yt = heap.data();
+        }
+        double yNorm[W], xNorm = 0;
+
+        for (size_t jb = j0; jb < j1; jb += W) {
+            size_t width = min(W, j1 - jb);
+            // Transpose the next W rows of Y (zero padded) so lanes run across rows
+            for (size_t k = 0; k < d; k++)
+                for (size_t l = 0; l < W; l++) yt[k * W + l] = l < width ? Y[(jb + l) * d + k] : 0.0;
+            if (metric == COSINE)
+                for (size_t l = 0; l < width; l++) yNorm[l] = selfDot(Y + (jb + l) * d, d);
+
+            for (size_t i = i0; i < i1; i++) {
+                const double* x = X + i * d;
+                alignas(64) double acc[W];
+                accumulate(x, yt, d, acc);
+                if (metric == COSINE) xNorm = selfDot(x, d);
+
+                double* o = out + (i - i0) * ld + (jb - j0);
+                for (size_t l = 0; l < width; l++) {
+                    if (metric == EUCLIDEAN) o[l] = sqrt(acc[l]);
+                    else if (metric == COSINE) o[l] = cosineFrom(acc[l], xNorm, yNorm[l]);
+                    else o[l] = acc[l];
+                }
+            }
+        }
+    }
+
+    // --- Stream every TILE x TILE block of X (n rows) against Y (m rows) to fn ---
+    // fn(i0, i1, j0, j1, tile, ld) runs on worker threads and must be thread-safe.
+    // symmetric (Y == X): only blocks with j0 >= i0 are produced.
+    template <class F>
+    void forEachTile(const double* X, size_t n, const double* Y, size_t m, size_t d, F fn,
+                     bool symmetric = false) const {
+        size_t tilesI = (n + TILE - 1) / TILE, tilesJ = (m + TILE - 1) / TILE;
+        vector<pair<size_t, size_t>> tiles;
+        for (size_t ti = 0; ti < tilesI; ti++)
+            for (size_t tj = symmetric ? ti : 0; tj < tilesJ; tj++) tiles.push_back({ti, tj});
+
+        int T = Parallel::resolveThreads(numThreads, tiles.size());
+        vector<vector<double>> buffers(T, vector<double>(TILE * TILE));
+        Parallel::forBlocks(tiles.size(), 1, T, [&](size_t b, size_t, int t) {
+            size_t i0 = tiles[b].first * TILE, j0 = tiles[b].second * TILE;
+            size_t i1 = min(n, i0 + TILE), j1 = min(m, j0 + TILE);
+            block(X, i0, i1, Y, j0, j1, d, buffers[t].data(), TILE);
+            fn(i0, i1, j0, j1, (const double*)buffers[t].data(), (size_t)TILE);
+        });
+    }
+
+    // --- Condensed upper triangle (pairs i < j in row order, like scipy pdist) ---
+    template <class T>
+    void condensed(const double* X, size_t n, size_t d, T* out) const {
+        forEachTile(X, n, X, n, d, [&](size_t i0, size_t i1, size_t j0, size_t j1, const double* tile, size_t ld) {
+            for (size_t i = i0; i < i1; i++) {
+                size_t jStart = max(j0, i + 1);
+                if (jStart >= j1) continue;
+                T* row = out + condensedIndex(n, i, jStart);
+                const double* src = tile + (i - i0) * ld + (jStart - j0);
+                for (size_t j = 0; j < j1 - jStart; j++) row[j] = (T)src[j];
+            }
+        }, true);
+    }
+
+    vector<double> condensed(const double* X, size_t n, size_t d) const {
+        vector<double> out(n * (n - 1) / 2);
+        condensed(X, n, d, out.data());
+        return out;
+    }
+
+    // Position of pair (i, j), i != j, in the condensed upper triangle
+    static size_t condensedIndex(size_t n, size_t i, size_t j) {
+        if (i > j) swap(i, j);
+        return i * n - i * (i + 1) / 2 + (j - i - 1);
+    }
+
+private:
+    static constexpr size_t W = 16;            // columns per SIMD pass
+    static constexpr size_t TILE = 128;        // rows/columns per streamed tile
+    static constexpr size_t MAX_D_STACK = 64;  // transposed block kept on the stack up to this d
+
+    static double selfDot(const double* a, size_t d) {
+        double s = 0;
+        for (size_t k = 0; k < d; k++) s += a[k] * a[k];
+        return s;
+    }
+
+    // Zero vectors have no direction; treat them as orthogonal to everything
+    static double cosineFrom(double dot, double na, double nb) {
+        if (na == 0 || nb == 0) return 1.0;
+        return 1.0 - dot / (sqrt(na) * sqrt(nb));
+    }
+
+    void accumulate(const double* x, const double* yt, size_t d, double* acc) const {
+#ifdef DISTANCE_X86
+        if (isa == AVX512) return accumulateAvx512(x, yt, d, acc);
+        if (isa == AVX2) return accumulateAvx2(x, yt, d, acc);
+#endif
+        accumulateScalar(x, yt, d, acc);
+    }
+
+    void accumulateScalar(const double* x, const double* yt, size_t d, double* acc) const {
+        for (size_t l = 0; l < W; l++) acc[l] = 0;
+        for (size_t k = 0; k < d; k++) {
+            const double* y = yt + k * W;
+            for (size_t l = 0; l < W; l++) {
+                if (metric == COSINE) acc[l] += x[k] * y[l];
+                else if (metric == MANHATTAN) acc[l] += fabs(x[k] - y[l]);
+                else {
+                    double t = x[k] - y[l];
+                    acc[l] += t * t;
+                }
+            }
+        }
+    }
+
+#ifdef DISTANCE_X86
+    __attribute__((target("avx2")))
+    void accumulateAvx2(const double* x, const double* yt, size_t d, double* acc) const {
+        __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+        __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        for (size_t k = 0; k < d; k++) {
+            const double* y = yt + k * W;
+            __m256d xv = _mm256_broadcast_sd(x + k);
+            __m256d t0, t1, t2, t3;
+            if (metric == COSINE) {
+                t0 = _mm256_mul_pd(xv, _mm256_loadu_pd(y));
+                t1 = _mm256_mul_pd(xv, _mm256_loadu_pd(y + 4));
+                t2 = _mm256_mul_pd(xv, _mm256_loadu_pd(y + 8));
+                t3 = _mm256_mul_pd(xv, _mm256_loadu_pd(y + 12));
+            } else {
+                t0 = _mm256_sub_pd(xv, _mm256_loadu_pd(y));
+                t1 = _mm256_sub_pd(xv, _mm256_loadu_pd(y + 4));
+                t2 = _mm256_sub_pd(xv, _mm256_loadu_pd(y + 8));
+                t3 = _mm256_sub_pd(xv, _mm256_loadu_pd(y + 12));
+                if (metric == MANHATTAN) {
+                    t0 = _mm256_andnot_pd(signMask, t0);
+                    t1 = _mm256_andnot_pd(signMask, t1);
+                    t2 = _mm256_andnot_pd(signMask, t2);
+                    t3 = _mm256_andnot_pd(signMask, t3);
+                } else {
+                    t0 = _mm256_mul_pd(t0, t0);
+                    t1 = _mm256_mul_pd(t1, t1);
+                    t2 = _mm256_mul_pd(t2, t2);
+                    t3 = _mm256_mul_pd(t3, t3);
+                }
+            }
+            a0 = _mm256_add_pd(a0, t0);
+            a1 = _mm256_add_pd(a1, t1);
+            a2 = _mm256_add_pd(a2, t2);
+            a3 = _mm256_add_pd(a3, t3);
+        }
+        _mm256_store_pd(acc, a0);
+        _mm256_store_pd(acc + 4, a1);
+        _mm256_store_pd(acc + 8, a2);
+        _mm256_store_pd(acc + 12, a3);
+    }
+
+    __attribute__((target("avx512f")))
+    void accumulateAvx512(const double* x, const double* yt, size_t d, double* acc) const {
+        __m512d a0 = _mm512_setzero_pd(), a1 = _mm512_setzero_pd();
+        for (size_t k = 0; k < d; k++) {
+            const double* y = yt + k * W;
+            __m512d xv = _mm512_set1_pd(x[k]);
+            __m512d t0, t1;
+            if (metric == COSINE) {
+                t0 = _mm512_mul_pd(xv, _mm512_loadu_pd(y));
+                t1 = _mm512_mul_pd(xv, _mm512_loadu_pd(y + 8));
+            } else {
+                t0 = _mm512_sub_pd(xv, _mm512_loadu_pd(y));
+                t1 = _mm512_sub_pd(xv, _mm512_loadu_pd(y + 8));
+                if (metric == MANHATTAN) {
+                    t0 = _mm512_abs_pd(t0);
+                    t1 = _mm512_abs_pd(t1);
+                } else {
+                    t0 = _mm512_mul_pd(t0, t0);
+                    t1 = _mm512_mul_pd(t1, t1);
+                }
+            }
+            a0 = _mm512_add_pd(a0, t0);
+            a1 = _mm512_add_pd(a1, t1);
+        }
+        _mm512_store_pd(acc, a0);
+        _mm512_store_pd(acc + 8, a1);
+    }
+#endif
+};
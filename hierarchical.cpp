@@ -1,107 +1,444 @@
 #include <bits/stdc++.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
 using namespace std;
 
+// --- Pairwise distances for the NN-chain (upper triangle, i < j) ---
+// Kept on the heap as plain condensed rows while it fits the budget. Past that it lives
+// in an unlinked scratch file mapped with mmap, so the kernel can page it out instead of
+// the process growing, and is laid out in 64 x 64 tiles (tile rows one after another):
+// the distances of one point then sit in n / 64 short runs rather than n scattered
+// entries, so a scan faults in a few tiles instead of a page per entry.
+template <class T>
+class DistanceStore {
+    vector<T> heap;
+    vector<size_t> rowStart;  // offset of tile row I, less I tiles (tile J of the row is at + J tiles)
+    T* ptr = nullptr;
+    size_t n = 0, tiles = 0, bytes = 0;
+    bool mapped = false;
+
+public:
+    static constexpr size_t TILE = 64;
+
+    DistanceStore() = default;
+    DistanceStore(const DistanceStore&) = delete;
+    DistanceStore& operator=(const DistanceStore&) = delete;
+    ~DistanceStore() {
+        if (mapped) munmap(ptr, bytes);
+    }
+
+    // budget = 0 means no limit
+    bool allocate(size_t points, size_t budget, const string& dir) {
+        n = points;
+        size_t pairs = n * (n - 1) / 2;
+        if (budget == 0 || pairs * sizeof(T) <= budget) {
+            heap.assign(pairs, T());
+            ptr = heap.data();
+            bytes = pairs * sizeof(T);
+            return true;
+        }
+
+        // Tiled file; diagonal tiles are stored whole
+        tiles = (n + TILE - 1) / TILE;
+        bytes = tiles * (tiles + 1) / 2 * TILE * TILE * sizeof(T);
+        rowStart.resize(tiles);
+        for (size_t I = 0, offset = 0; I < tiles; offset += tiles - I, I++) rowStart[I] = (offset - I) * TILE * TILE;
+        string path = dir + "/linkage-XXXXXX";
+        int fd = mkstemp(&path[0]);
+        if (fd < 0) {
+            cerr << "Error: Cannot create spill file in " << dir << "." << endl;
+            return false;
+        }
+        unlink(path.c_str());  // gone once unmapped
+        bool ok = ftruncate(fd, bytes) == 0;
+        void* p = ok ? mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (p == MAP_FAILED) {
+            cerr << "Error: Cannot map a " << bytes / 1048576.0 << " MB spill file in " << dir << "." << endl;
+            return false;
+        }
+        // No readahead: it would also build large page-cache folios, and a fault maps a
+        // whole folio, so every scan would pull far more of the file in than it reads
+        madvise(p, bytes, MADV_RANDOM);
+        ptr = (T*)p;
+        mapped = true;
+        return true;
+    }
+
+    // Distance between points i != j
+    T& at(size_t i, size_t j) {
+        if (i > j) swap(i, j);
+        if (!mapped) return ptr[i * n - i * (i + 1) / 2 + (j - i - 1)];
+        return ptr[rowStart[i / TILE] + (j / TILE) * TILE * TILE + (i % TILE) * TILE + j % TILE];
+    }
+
+    bool spilled() const { return mapped; }
+    size_t sizeBytes() const { return bytes; }
+
+    // Drop our resident pages of a spilled matrix; the contents stay in the file
+    void trim() {
+        if (mapped) madvise(ptr, bytes, MADV_DONTNEED);
+    }
+};
+
 class HierarchicalClustering {
+public:
+    enum Linkage { SINGLE, COMPLETE, AVERAGE, WARD };
+
+    // One agglomeration step. Ids 0..n-1 are the points, n + s is the cluster made at step s
+    struct Merge {
+        int a, b;
+        double distance;
+        int size;
+    };
+
 private:
-    Dataset data;
     int nRows, nCols;
-    string linkage; // single, complete, average
-    vector<vector<double>> numericData;
+    string linkage; // single, complete, average, ward
+    Linkage method = SINGLE;
+    vector<double> points;   // nRows x nCols, row-major
+    vector<Merge> merges;    // n - 1 steps in order of distance
+    vector<int> labels;
+    int numThreads = 0;      // 0 = hardware concurrency
+    DistanceKernel::Metric metric = DistanceKernel::EUCLIDEAN;
 
-public:
-    HierarchicalClustering(Dataset d, string link = "single") {
-        data = d;
-        linkage = link;
-        nRows = d.rows.size();
-        nCols = d.headers.size();
+    // Condensed matrix settings for the NN-chain linkages
+    bool float32 = false;
+    size_t memoryBudget = 0;  // bytes, 0 = no limit
+    string spillDir = "/tmp";
+    size_t matrixBytes = 0;   // last build
+    bool matrixSpilled = false;
 
-        numericData.resize(nRows, vector<double>(nCols));
-        for (int i = 0; i < nRows; i++) {
-            for (int j = 0; j < nCols; j++) {
-                try {
-                    numericData[i][j] = stod(d.rows[i][j]);
-                } catch (...) {
-                    numericData[i][j] = 0.0;
+    static Linkage parseLinkage(const string& name) {
+        if (name == "single") return SINGLE;
+        if (name == "complete") return COMPLETE;
+        if (name == "average") return AVERAGE;
+        if (name == "ward") return WARD;
+        cerr << "Unknown linkage '" << name << "', using single." << endl;
+        return SINGLE;
+    }
+
+    static string linkageName(Linkage m) {
+        static const char* names[] = {"single", "complete", "average", "ward"};
+        return names[m];
+    }
+
+    // --- SLINK (Sibson): single linkage in O(n^2) time and O(n) memory ---
+    // Distances for the next 64 points are produced together, columns split across threads.
+    void slink() {
+        const size_t BLOCK = 64;
+        size_t n = nRows;
+        vector<int> pi(n);
+        vector<double> lambda(n), M(n);
+        vector<double> rows(BLOCK * n);
+        DistanceKernel kernel(metric);
+        for (size_t i = 0; i < n; i++) {
+            if (i % BLOCK == 0) {
+                size_t i1 = min(n, i + BLOCK);
+                Parallel::forRange(i1, Parallel::resolveThreads(numThreads, i1 / 1024 + 1), [&](size_t b, size_t e, int) {
+                    kernel.block(points.data(), i, i1, points.data(), b, e, nCols, &rows[b], n);
+                });
+            }
+            const double* dist = &rows[(i % BLOCK) * n];
+
+            pi[i] = i;
+            lambda[i] = INFINITY;
+            for (size_t j = 0; j < i; j++) M[j] = dist[j];
+            for (size_t j = 0; j < i; j++) {
+                if (lambda[j] >= M[j]) {
+                    M[pi[j]] = min(M[pi[j]], lambda[j]);
+                    lambda[j] = M[j];
+                    pi[j] = i;
+                } else {
+                    M[pi[j]] = min(M[pi[j]], M[j]);
                 }
             }
+            for (size_t j = 0; j < i; j++)
+                if (lambda[j] >= lambda[pi[j]]) pi[j] = i;
         }
-    }
 
-    double euclideanDistance(const vector<double>& a, const vector<double>& b) {
-        double sum = 0.0;
-        for (int i = 0; i < nCols; i++)
-            sum += pow(a[i] - b[i], 2);
-        return sqrt(sum);
+        // Pointer representation: point j joins pi[j]'s cluster at height lambda[j]
+        vector<Merge> raw;
+        for (size_t j = 0; j + 1 < n; j++) raw.push_back({(int)j, pi[j], lambda[j], 0});
+        finishMerges(raw);
     }
 
-    double clusterDistance(const vector<int>& c1, const vector<int>& c2) {
-        vector<double> dists;
-        for (int i : c1) {
-            for (int j : c2) {
-                dists.push_back(euclideanDistance(numericData[i], numericData[j]));
+    // --- Nearest-neighbour chain with Lance-Williams updates on the pairwise distances ---
+    // Ward works on squared distances internally and reports Euclidean heights.
+    // T is the stored precision; updates are always computed in double.
+    template <class T>
+    void nnChain() {
+        size_t n = nRows;
+        DistanceStore<T> D;
+        if (!D.allocate(n, memoryBudget, spillDir)) return;
+        matrixBytes = D.sizeBytes();
+        matrixSpilled = D.spilled();
+
+        // Spilled pages are released whenever they take us half a budget past this point
+        size_t rssLimit = residentBytes() + memoryBudget / 2;
+        auto release = [&]() {
+            if (D.spilled() && residentBytes() > rssLimit) D.trim();
+        };
+
+        // Fill one band of tile rows at a time (the whole matrix when it is in memory);
+        // a band of a spilled matrix is about a quarter of the budget
+        DistanceKernel kernel(method == WARD ? DistanceKernel::SQEUCLIDEAN : metric, numThreads);
+        size_t tileRows = DistanceStore<T>::TILE, band = n;
+        if (D.spilled()) band = max(tileRows, memoryBudget / 4 / (n * sizeof(T)) / tileRows * tileRows);
+        for (size_t r0 = 0; r0 + 1 < n; r0 += band) {
+            const double* B = points.data() + r0 * nCols;
+            kernel.forEachTile(B, min(n, r0 + band) - r0, B, n - r0, nCols,
+                               [&](size_t i0, size_t i1, size_t j0, size_t j1, const double* tile, size_t ld) {
+                for (size_t i = i0; i < i1; i++)
+                    for (size_t j = max(j0, i + 1); j < j1; j++)
+                        D.at(r0 + i, r0 + j) = (T)tile[(i - i0) * ld + (j - j0)];
+            }, true);
+            release();
+        }
+
+        // Active slots stay compact and ascending, so scans shrink as clusters merge
+        // and still walk each row of the matrix in memory order
+        vector<int> size(n, 1);
+        vector<int> active(n);
+        iota(active.begin(), active.end(), 0);
+        vector<int> chain;
+        vector<Merge> raw;
+        for (size_t step = 0; step + 1 < n; step++) {
+            if (chain.empty()) chain.push_back(active[0]);
+
+            // Grow the chain until its last two entries are reciprocal nearest neighbours
+            while (true) {
+                release();
+                int a = chain.back();
+                int prev = chain.size() >= 2 ? chain[chain.size() - 2] : -1;
+                int b = prev;  // on ties keep the previous link so the chain terminates
+                double best = prev >= 0 ? D.at(a, prev) : INFINITY;
+                for (int k : active) {
+                    if (k == a) continue;
+                    double v = D.at(a, k);
+                    if (v < best || b < 0) {
+                        best = v;
+                        b = k;
+                    }
+                }
+                if (b == prev) break;
+                chain.push_back(b);
+            }
+
+            int a = chain.back(); chain.pop_back();
+            int b = chain.back(); chain.pop_back();
+            double dab = D.at(a, b);
+            raw.push_back({a, b, method == WARD ? sqrt(dab) : dab, 0});
+
+            // The merged cluster keeps the lower slot. Slots are visited in ascending order,
+            // so the three rows are each read front to back.
+            int keep = min(a, b), drop = max(a, b);
+            double na = size[a], nb = size[b];
+            release();
+            for (int k : active) {
+                if (k == a || k == b) continue;
+                double da = D.at(k, a), db = D.at(k, b);
+                double v;
+                if (method == SINGLE) v = min(da, db);
+                else if (method == COMPLETE) v = max(da, db);
+                else if (method == AVERAGE) v = (na * da + nb * db) / (na + nb);
+                else {
+                    double nk = size[k];
+                    v = ((nk + na) * da + (nk + nb) * db - nk * dab) / (nk + na + nb);
+                }
+                D.at(k, keep) = (T)v;
             }
+            active.erase(lower_bound(active.begin(), active.end(), drop));
+            size[keep] = na + nb;
         }
+        finishMerges(raw);
+    }
+
+    // Sort raw merges (given as any point of each side) by height and renumber them
+    // as cluster ids: points are 0..n-1 and the cluster formed at step s is n + s
+    void finishMerges(vector<Merge>& raw) {
+        stable_sort(raw.begin(), raw.end(), [](const Merge& x, const Merge& y) { return x.distance < y.distance; });
+
+        vector<int> parent(nRows), clusterId(nRows), clusterSize(nRows, 1);
+        iota(parent.begin(), parent.end(), 0);
+        iota(clusterId.begin(), clusterId.end(), 0);
+        auto find = [&](int x) {
+            while (parent[x] != x) x = parent[x] = parent[parent[x]];
+            return x;
+        };
+
+        merges.clear();
+        for (size_t s = 0; s < raw.size(); s++) {
+            int ra = find(raw[s].a), rb = find(raw[s].b);
+            int ida = clusterId[ra], idb = clusterId[rb];
+            int total = clusterSize[ra] + clusterSize[rb];
+            merges.push_back({min(ida, idb), max(ida, idb), raw[s].distance, total});
+            parent[rb] = ra;
+            clusterSize[ra] = total;
+            clusterId[ra] = nRows + s;
+        }
+    }
+
+    // Labels after applying the first m merges, numbered 1.. by smallest point
+    vector<int> applyMerges(int m) const {
+        vector<int> parent(nRows);
+        iota(parent.begin(), parent.end(), 0);
+        auto find = [&](int x) {
+            while (parent[x] != x) x = parent[x] = parent[parent[x]];
+            return x;
+        };
 
-        if (linkage == "single") return *min_element(dists.begin(), dists.end());
-        if (linkage == "complete") return *max_element(dists.begin(), dists.end());
-        if (linkage == "average") {
-            double sum = accumulate(dists.begin(), dists.end(), 0.0);
-            return sum / dists.size();
+        // Representative point of every cluster id, so merges can be replayed on points
+        vector<int> rep(nRows + m);
+        iota(rep.begin(), rep.begin() + nRows, 0);
+        for (int s = 0; s < m; s++) {
+            int ra = find(rep[merges[s].a]), rb = find(rep[merges[s].b]);
+            parent[max(ra, rb)] = min(ra, rb);
+            rep[nRows + s] = min(ra, rb);
         }
 
-        return *min_element(dists.begin(), dists.end()); // default single
+        vector<int> out(nRows, 0);
+        vector<int> idOfRoot(nRows, 0);
+        int next = 0;
+        for (int i = 0; i < nRows; i++) {
+            int r = find(i);
+            if (!idOfRoot[r]) idOfRoot[r] = ++next;
+            out[i] = idOfRoot[r];
+        }
+        return out;
     }
 
-    void run(int targetClusters = 1, bool verbose = true) {
-        vector<vector<int>> clusters;
-        for (int i = 0; i < nRows; i++)
-            clusters.push_back({i});
+    bool hasDendrogram() const {
+        if ((int)merges.size() == max(0, nRows - 1)) return true;
+        cerr << "Error: No dendrogram yet; call run() or loadLinkage() first." << endl;
+        return false;
+    }
+
+    // Binary linkage file: header, then (n - 1) rows of 4 doubles (a, b, distance, size)
+    struct LinkageHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t method;
+        uint64_t n;
+    };
+    static constexpr char LINKAGE_MAGIC[8] = {'D', 'M', '2', 'L', 'I', 'N', 'K', '\0'};
 
-        int step = 1;
+public:
+    // Empty model, e.g. to loadLinkage() a saved dendrogram and cut it without the data
+    HierarchicalClustering() : nRows(0), nCols(0), linkage("single") {}
+
+    HierarchicalClustering(const Dataset& d, string link = "single") {
+        linkage = link;
+        method = parseLinkage(link);
+        nRows = d.size();
+        nCols = d.headers.size();
+        size_t missing = 0;
+        points = d.columnar().numericMatrix(&missing);
+        if (missing) cerr << "Warning: " << missing << " missing cells filled with column means." << endl;
+    }
+
+    double euclideanDistance(const double* a, const double* b) const {
+        return DistanceKernel::distance(a, b, nCols, DistanceKernel::EUCLIDEAN);
+    }
+
+    // --- Point metric for single / complete / average (Ward is always Euclidean) ---
+    void setMetric(DistanceKernel::Metric m) {
+        if (method == WARD && m != DistanceKernel::EUCLIDEAN)
+            cerr << "Warning: Ward linkage needs Euclidean distances; metric ignored." << endl;
+        metric = m;
+    }
+
+    // --- Full dendrogram: SLINK for single linkage, NN-chain for the others ---
+    void buildDendrogram() {
+        merges.clear();
+        if (nRows < 2) return;
+        matrixBytes = 0;
+        matrixSpilled = false;
+        if (method == SINGLE) slink();
+        else if (float32) nnChain<float>();
+        else nnChain<double>();
+    }
+
+    // --- Condensed matrix precision and memory budget (not used by single linkage) ---
+    // float32 halves the matrix; merges whose heights only differ beyond float precision
+    // may come out in a different order.
+    void setFloat32(bool on) { float32 = on; }
+
+    // A matrix larger than budgetMB is backed by a scratch file in dir (0 = no limit)
+    void setMemoryBudget(double budgetMB, const string& dir = "/tmp") {
+        memoryBudget = budgetMB > 0 ? (size_t)(budgetMB * 1048576) : 0;
+        spillDir = dir;
+    }
+
+    // Current resident set size from /proc (0 where unavailable)
+    static size_t residentBytes() {
+        ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        if (!(statm >> pages >> resident)) return 0;
+        return resident * (size_t)sysconf(_SC_PAGESIZE);
+    }
+
+    // Peak resident set size of the process so far, in MB
+    static double peakRssMB() {
+        rusage ru;
+        if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+        return ru.ru_maxrss / 1024.0;  // kilobytes on Linux
+    }
+
+    void printMemoryReport() const {
+        cout << "Distance matrix: ";
+        if (method == SINGLE) cout << "none (SLINK)\n";
+        else cout << matrixBytes / 1048576.0 << " MB " << (float32 ? "float32" : "float64")
+                  << (matrixSpilled ? ", spilled to " + spillDir : ", in memory") << "\n";
+        cout << "Peak RSS: " << peakRssMB() << " MB";
+        if (memoryBudget) cout << " (budget " << memoryBudget / 1048576.0 << " MB)";
+        cout << endl;
+    }
+
+    void run(int targetClusters = 1, bool verbose = true) {
+        targetClusters = max(1, min(targetClusters, nRows));
 
         if (verbose) {
             cout << "\n--- Hierarchical Clustering (Agglomerative) ---\n";
             cout << "Linkage Method: " << linkage << "\n";
+            cout << "Distance: " << DistanceKernel::metricName(method == WARD ? DistanceKernel::EUCLIDEAN : metric) << "\n";
             cout << "Starting with " << nRows << " singleton clusters.\n";
             cout << "Target Clusters: " << targetClusters << "\n";
         }
 
-        while (clusters.size() > targetClusters) {
-            double minDist = 1e9;
-            int c1 = -1, c2 = -1;
+        auto t0 = chrono::steady_clock::now();
+        buildDendrogram();
+        if (!hasDendrogram()) return;
+        labels = cutAt(targetClusters);
 
-            // Compute pairwise distances between clusters
-            for (int i = 0; i < clusters.size(); i++) {
-                for (int j = i + 1; j < clusters.size(); j++) {
-                    double dist = clusterDistance(clusters[i], clusters[j]);
-                    if (dist < minDist) {
-                        minDist = dist;
-                        c1 = i;
-                        c2 = j;
-                    }
-                }
-            }
-
-            if (verbose) {
-                cout << "\nStep " << step++ << ": Merging clusters ";
+        if (verbose) {
+            // Member lists are only rebuilt for the printed steps
+            vector<vector<int>> members(nRows);
+            for (int i = 0; i < nRows; i++) members[i] = {i};
+            int remaining = nRows;
+            for (int s = 0; s < nRows - targetClusters; s++) {
+                const Merge& m = merges[s];
+                cout << "\nStep " << s + 1 << ": Merging clusters ";
                 cout << "{ ";
-                for (int x : clusters[c1]) cout << x << " ";
+                for (int x : members[m.a]) cout << x << " ";
                 cout << "} and { ";
-                for (int x : clusters[c2]) cout << x << " ";
-                cout << "}  →  Distance: " << minDist << "\n";
-            }
+                for (int x : members[m.b]) cout << x << " ";
+                cout << "}  →  Distance: " << m.distance << "\n";
 
-            // Merge c2 into c1
-            clusters[c1].insert(clusters[c1].end(), clusters[c2].begin(), clusters[c2].end());
-            clusters.erase(clusters.begin() + c2);
-
-            if (verbose) {
-                cout << "Clusters remaining: " << clusters.size() << endl;
+                vector<int> merged = std::move(members[m.a]);
+                merged.insert(merged.end(), members[m.b].begin(), members[m.b].end());
+                members[m.b].clear();
+                members.push_back(std::move(merged));
+                cout << "Clusters remaining: " << --remaining << endl;
             }
-        }
 
-        if (verbose) {
-            cout << "\n--- Final Clusters (" << clusters.size() << ") ---\n";
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            cout << "\n";
+            printMemoryReport();
+            cout << "\n--- Final Clusters (" << targetClusters << ", " << ms << " ms) ---\n";
+            vector<vector<int>> clusters(targetClusters);
+            for (int i = 0; i < nRows; i++) clusters[labels[i] - 1].push_back(i);
             int cid = 1;
             for (auto& c : clusters) {
                 cout << "Cluster " << cid++ << ": ";
@@ -111,4 +448,120 @@ public:
             }
         }
     }
+
+    vector<int> getLabels() { return labels; }
+    const vector<Merge>& getMerges() const { return merges; }
+
+    // --- Labels (1..k) for exactly k clusters, from the stored dendrogram ---
+    vector<int> cutAt(int k) const {
+        if (!hasDendrogram()) return {};
+        k = max(1, min(k, nRows));
+        return applyMerges(nRows - k);
+    }
+
+    // --- Labels after every merge at height <= h ---
+    vector<int> cutAtDistance(double h) const {
+        if (!hasDendrogram()) return {};
+        auto it = upper_bound(merges.begin(), merges.end(), h,
+                              [](double v, const Merge& m) { return v < m.distance; });
+        return applyMerges(it - merges.begin());
+    }
+
+    // --- Linkage matrix export (scipy layout: cluster1, cluster2, distance, size) ---
+    bool saveLinkageCSV(const string& filename) const {
+        if (!hasDendrogram()) return false;
+        ofstream out(filename);
+        if (!out.is_open()) {
+            cerr << "Error: Could not write " << filename << endl;
+            return false;
+        }
+        out << "cluster1,cluster2,distance,size\n";
+        out << setprecision(17);
+        for (auto& m : merges) out << m.a << "," << m.b << "," << m.distance << "," << m.size << "\n";
+        return out.good();
+    }
+
+    bool saveLinkage(const string& filename) const {
+        if (!hasDendrogram()) return false;
+        ofstream out(filename, ios::binary);
+        if (!out.is_open()) {
+            cerr << "Error: Could not write " << filename << endl;
+            return false;
+        }
+        LinkageHeader header;
+        memcpy(header.magic, LINKAGE_MAGIC, sizeof(header.magic));
+        header.version = 1;
+        header.method = method;
+        header.n = nRows;
+        out.write((const char*)&header, sizeof(header));
+        for (auto& m : merges) {
+            double row[4] = {(double)m.a, (double)m.b, m.distance, (double)m.size};
+            out.write((const char*)row, sizeof(row));
+        }
+        return out.good();
+    }
+
+    // Replaces the dendrogram (and row count) with one written by saveLinkage()
+    bool loadLinkage(const string& filename) {
+        ifstream in(filename, ios::binary);
+        LinkageHeader header;
+        if (!in.is_open() || !in.read((char*)&header, sizeof(header)) ||
+            memcmp(header.magic, LINKAGE_MAGIC, sizeof(header.magic)) != 0 || header.version != 1) {
+            cerr << "Error: " << filename << " is not a DM2 linkage file." << endl;
+            return false;
+        }
+        if (!points.empty() && header.n != (uint64_t)nRows) {
+            cerr << "Error: Linkage has " << header.n << " rows, dataset has " << nRows << endl;
+            return false;
+        }
+
+        // The header is untrusted: size the merges from the file length, not from n alone
+        in.seekg(0, ios::end);
+        uint64_t rowsInFile = ((uint64_t)in.tellg() - sizeof(header)) / (4 * sizeof(double));
+        in.seekg(sizeof(header));
+        if (header.method > WARD || header.n == 0 || header.n > (uint64_t)INT_MAX / 2 ||
+            header.n - 1 > rowsInFile) {
+            cerr << "Error: Linkage file " << filename << " is corrupt or truncated." << endl;
+            return false;
+        }
+
+        // Every id must name a point or an earlier cluster that is not merged yet, the
+        // stored size must match its two children, and heights must not decrease
+        // (cutAtDistance() binary-searches them)
+        int n = (int)header.n;
+        vector<Merge> loaded(n - 1);
+        vector<int> sizes(2 * n - 1, 0);
+        fill(sizes.begin(), sizes.begin() + n, 1);
+        for (int s = 0; s < n - 1; s++) {
+            double row[4];
+            in.read((char*)row, sizeof(row));
+            auto validId = [&](double id) { return id >= 0 && id < n + s && id == floor(id) && sizes[(int)id] > 0; };
+            if (!validId(row[0]) || !validId(row[1]) || row[0] == row[1] || std::isnan(row[2]) ||
+                (s > 0 && !(row[2] >= loaded[s - 1].distance)) ||
+                row[3] != (double)(sizes[(int)row[0]] + sizes[(int)row[1]])) {
+                cerr << "Error: Linkage file " << filename << " has an invalid merge at step " << s << "." << endl;
+                return false;
+            }
+            Merge& m = loaded[s];
+            m = {(int)row[0], (int)row[1], row[2], (int)row[3]};
+            sizes[n + s] = m.size;
+            sizes[m.a] = sizes[m.b] = 0;
+        }
+        nRows = header.n;
+        method = (Linkage)header.method;
+        linkage = linkageName(method);
+        merges = std::move(loaded);
+        return true;
+    }
+
+    void printLinkage(int maxRows = 20) const {
+        cout << "\nLinkage matrix (" << merges.size() << " merges)\n";
+        cout << setw(10) << "cluster1" << setw(10) << "cluster2" << setw(14) << "distance" << setw(8) << "size" << endl;
+        for (int s = 0; s < (int)merges.size() && s < maxRows; s++)
+            cout << setw(10) << merges[s].a << setw(10) << merges[s].b << setw(14) << merges[s].distance
+                 << setw(8) << merges[s].size << endl;
+        if ((int)merges.size() > maxRows) cout << "  ... " << merges.size() - maxRows << " more\n";
+    }
+
+    void setThreads(int threads) { numThreads = threads; }
 };
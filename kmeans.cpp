@@ -1,142 +1,562 @@
 class KMeans {
+public:
+    // LLOYD scans every centroid with the SIMD kernel; HAMERLY / ELKAN keep
+    // triangle-inequality bounds and skip distances that cannot change a label.
+    enum Algorithm { LLOYD, HAMERLY, ELKAN, AUTO_BOUNDS };
+
 private:
-    Dataset data;
     int k;
-    vector<vector<double>> numericData;
-    vector<vector<double>> centroids;
+    size_t n = 0, d = 0;
+    vector<double> points;       // n x d, row-major
+    vector<double> pointNorms;   // ||x||^2 per row
+    vector<double> centroids;    // k x d, row-major
     vector<int> labels;
+    vector<double> bestDist2;    // squared distance to the assigned centroid
+    KMeansKernel kernel;
+    bool verbose = true;
+    int numThreads = 0;          // 0 = hardware concurrency
 
-    void convertToNumeric() {
-        for (auto& row : data.rows) {
-            vector<double> v;
-            for (auto& col : row) {
-                try {
-                    v.push_back(stod(col)); // Convert string → double
-                } catch (...) {
-                    cerr << "Non-numeric value found: " << col << endl;
-                    v.push_back(0.0);
-                }
-            }
-            numericData.push_back(v);
+    // Per-thread centroid accumulators, allocated once per run
+    vector<vector<double>> threadSums;
+    vector<vector<int>> threadCounts;
+    vector<double> prevCentroids;
+
+    // Bounds state (Hamerly / Elkan)
+    Algorithm algorithm = LLOYD;
+    vector<double> upper;        // n, distance to assigned centroid (upper bound)
+    vector<double> lower;        // Hamerly: n (second closest); Elkan: n x k
+    vector<double> centerDist;   // k x k
+    vector<double> halfMin;      // half distance to the nearest other centroid
+    vector<double> drift;        // how far each centroid moved last iteration
+    double maxDrift = 0, secondDrift = 0;
+    int maxDriftIdx = -1;
+    vector<long long> threadEvals;
+    long long distEvaluated = 0, distPossible = 0;
+
+    // Relative slack so rounding in the bounds can never skip a real candidate
+    static constexpr double BOUND_SLACK = 1e-10;
+
+    // Mini-batch / online state: per-centroid sample counts drive the learning rates
+    vector<long long> centerCounts;
+    vector<double> batchPoints, batchNorms;
+    vector<int> batchLabels;
+
+    // Seeding: fixed default seed so runs are reproducible; see setSeed / setInit
+    KMeansSeeding seeding;
+    KMeansSeeding::Method initMethod = KMeansSeeding::PLUS_PLUS;
+    uint64_t seed = mt19937_64::default_seed;
+    mt19937_64 rng{seed};
+    int iterationsRun = 0;
+    double seedingMs = 0;
+
+    static void warnCategorical(const Dataset& data) {
+        const ColumnStore& cs = data.columnar();
+        for (size_t j = 0; j < cs.numCols(); j++)
+            if (cs.cols[j].type == COL_CATEGORICAL)
+                cerr << "Non-numeric column found: " << data.headers[j] << " (non-numeric cells treated as missing)" << endl;
+    }
+
+    static void warnMissing(size_t missing) {
+        if (missing) cerr << "Warning: " << missing << " missing cells filled with column means." << endl;
+    }
+
+    // Points are built straight from the columnar view; the Dataset is not kept
+    void convertToNumeric(const Dataset& data) {
+        warnCategorical(data);
+        const ColumnStore& cs = data.columnar();
+        n = cs.nRows;
+        d = cs.numCols();
+        size_t missing = 0;
+        points = cs.numericMatrix(&missing);
+        warnMissing(missing);
+        pointNorms.resize(n);
+        KMeansKernel::rowNorms(points.data(), n, d, pointNorms.data());
+    }
+
+    const double* point(size_t i) const { return &points[i * d]; }
+    double* centroid(int c) { return &centroids[c * d]; }
+
+    double euclidDist(const double* a, const double* b) const {
+        return DistanceKernel::distance(a, b, d, DistanceKernel::EUCLIDEAN);
+    }
+
+    void initCentroids() { initCentroids(points.data(), n); }
+
+    void initCentroids(const double* X, size_t m) {
+        if (verbose)
+            cout << "\n🔹 Initializing " << k << " centroids (" << KMeansSeeding::methodName(initMethod) << ")...\n";
+        auto t0 = chrono::steady_clock::now();
+        seeding.numThreads = numThreads;
+        centroids = seeding.seed(initMethod, X, m, d, k, rng);
+        seedingMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+        if (verbose) printCentroids();
+    }
+
+    double pointCentroidDist(size_t i, int c) const { return euclidDist(point(i), &centroids[c * d]); }
+
+    void allocateBuffers(int threads) {
+        labels.assign(n, -1);
+        bestDist2.assign(n, 0.0);
+        prevCentroids.assign(k * d, 0.0);
+        threadSums.assign(threads, vector<double>(k * d));
+        threadCounts.assign(threads, vector<int>(k));
+        threadEvals.assign(threads, 0);
+        distEvaluated = distPossible = 0;
+
+        if (algorithm == HAMERLY || algorithm == ELKAN) {
+            upper.assign(n, 0.0);
+            lower.assign(algorithm == ELKAN ? n * k : n, 0.0);
+            centerDist.assign(k * k, 0.0);
+            halfMin.assign(k, 0.0);
+            drift.assign(k, 0.0);
+        }
+    }
+
+    void clearAccumulators(int t) {
+        fill(threadSums[t].begin(), threadSums[t].end(), 0.0);
+        fill(threadCounts[t].begin(), threadCounts[t].end(), 0);
+    }
+
+    void accumulate(int t, size_t i) {
+        int c = labels[i];
+        threadCounts[t][c]++;
+        const double* x = point(i);
+        double* s = &threadSums[t][c * d];
+        for (size_t j = 0; j < d; j++) s[j] += x[j];
+    }
+
+    // Reduce into thread 0's buffers; empty clusters keep their previous position
+    void reduceCentroids(int T) {
+        for (int t = 1; t < T; t++) {
+            for (size_t x = 0; x < k * d; x++) threadSums[0][x] += threadSums[t][x];
+            for (int c = 0; c < k; c++) threadCounts[0][c] += threadCounts[t][c];
+        }
+        for (int c = 0; c < k; c++) {
+            int count = threadCounts[0][c];
+            if (count == 0) continue;
+            for (size_t j = 0; j < d; j++)
+                centroids[c * d + j] = threadSums[0][c * d + j] / count;
         }
     }
 
-    double euclidDist(const vector<double>& a, const vector<double>& b) {
-        double sum = 0;
-        for (int i = 0; i < a.size(); i++)
-            sum += pow(a[i] - b[i], 2);
-        return sqrt(sum);
+    void printAssignments() {
+        for (size_t i = 0; i < n; i++)
+            cout << "  Point " << i << " assigned to Cluster " << labels[i]
+                 << " (dist=" << fixed << setprecision(4) << sqrt(bestDist2[i]) << ")\n";
+        cout << "\n Recomputing centroids...\n";
     }
 
-    void initCentroids() {
-        cout << "\n🔹 Initializing " << k << " random centroids...\n";
-        unordered_set<int> used;
-        srand(time(0));
+    // One Lloyd iteration: each worker assigns its row partition and accumulates
+    // sums/counts for the rows it just assigned; partials are reduced afterwards.
+    void lloydStep(WorkerPool& pool) {
+        if (verbose) cout << "\nAssigning clusters to each point...\n";
+        kernel.setCentroids(centroids.data(), k, d);
 
-        while (centroids.size() < k) {
-            int idx = rand() % numericData.size();
-            if (!used.count(idx)) {
-                centroids.push_back(numericData[idx]);
-                used.insert(idx);
-                cout << "  Centroid " << centroids.size()-1 << " initialized with row " << idx << endl;
+        int T = pool.size();
+        auto work = [&](int t) {
+            size_t begin = n * t / T, end = n * (t + 1) / T;
+            clearAccumulators(t);
+
+            // Small blocks keep the points in cache between assignment and accumulation
+            for (size_t b = begin; b < end; b += 256) {
+                size_t e = min(end, b + 256);
+                kernel.assign(points.data(), pointNorms.data(), b, e, labels.data(), bestDist2.data());
+                for (size_t i = b; i < e; i++) accumulate(t, i);
             }
+        };
+        pool.run(work);
+        distEvaluated += (long long)n * k;
+        distPossible += (long long)n * k;
+
+        if (verbose) printAssignments();
+        reduceCentroids(T);
+        if (verbose) printCentroids();
+    }
+
+    // --- Bounds-based iteration (Hamerly / Elkan) ---
+    void computeCenterBounds() {
+        DistanceKernel(DistanceKernel::EUCLIDEAN).block(centroids.data(), 0, k, centroids.data(), 0, k, d,
+                                                       centerDist.data(), k);
+        for (int a = 0; a < k; a++) {
+            halfMin[a] = INFINITY;
+            for (int c = 0; c < k; c++)
+                if (c != a) halfMin[a] = min(halfMin[a], 0.5 * centerDist[a * k + c]);
         }
+    }
+
+    bool provablyCloser(double u, double bound) const { return u * (1 + BOUND_SLACK) < bound; }
 
-        printCentroids();
+    // Full scan: exact argmin (lowest index on ties) plus second-best distance
+    void scanAll(size_t i, long long& evals) {
+        double best = INFINITY, second = INFINITY;
+        int bestC = 0;
+        for (int c = 0; c < k; c++) {
+            double dist = pointCentroidDist(i, c);
+            if (algorithm == ELKAN) lower[i * k + c] = dist;
+            if (dist < best) {
+                second = best;
+                best = dist;
+                bestC = c;
+            } else if (dist < second) {
+                second = dist;
+            }
+        }
+        evals += k;
+        labels[i] = bestC;
+        upper[i] = best;
+        if (algorithm == HAMERLY) lower[i] = second;
     }
 
-    void assignClusters() {
-        labels.assign(numericData.size(), -1);
-        cout << "\nAssigning clusters to each point...\n";
+    void hamerlyPoint(size_t i, long long& evals) {
+        int a = labels[i];
+        upper[i] += drift[a];
+        lower[i] -= (a == maxDriftIdx ? secondDrift : maxDrift);
+
+        double m = max(halfMin[a], lower[i]);
+        if (provablyCloser(upper[i], m)) return;
+        upper[i] = pointCentroidDist(i, a);
+        evals++;
+        if (provablyCloser(upper[i], m)) return;
+        scanAll(i, evals);
+        evals--;  // distance to a was already counted
+    }
 
-        for (int i = 0; i < numericData.size(); i++) {
-            double bestDist = 1e18;
-            int bestCluster = -1;
+    void elkanPoint(size_t i, long long& evals) {
+        int a = labels[i];
+        double* l = &lower[i * k];
+        double u = upper[i] + drift[a];
+        for (int c = 0; c < k; c++) l[c] = max(0.0, l[c] - drift[c]);
+
+        if (!provablyCloser(u, halfMin[a])) {
+            bool stale = true;
             for (int c = 0; c < k; c++) {
-                double d = euclidDist(numericData[i], centroids[c]);
-                if (d < bestDist) {
-                    bestDist = d;
-                    bestCluster = c;
+                if (c == a) continue;
+                double z = max(l[c], 0.5 * centerDist[a * k + c]);
+                if (provablyCloser(u, z)) continue;
+                if (stale) {
+                    u = pointCentroidDist(i, a);
+                    l[a] = u;
+                    evals++;
+                    stale = false;
+                    if (provablyCloser(u, z)) continue;
+                }
+                double dist = pointCentroidDist(i, c);
+                l[c] = dist;
+                evals++;
+                if (dist < u || (dist == u && c < a)) {
+                    a = c;
+                    u = dist;
                 }
             }
-            labels[i] = bestCluster;
-            cout << "  Point " << i << " assigned to Cluster " << bestCluster
-                 << " (dist=" << fixed << setprecision(4) << bestDist << ")\n";
         }
+        labels[i] = a;
+        upper[i] = u;
     }
 
-    void recomputeCentroids() {
-        cout << "\n Recomputing centroids...\n";
+    void boundsStep(WorkerPool& pool, bool first) {
+        if (verbose) cout << "\nAssigning clusters to each point...\n";
+        computeCenterBounds();
 
-        vector<vector<double>> newC(k, vector<double>(numericData[0].size(), 0));
-        vector<int> count(k, 0);
-
-        for (int i = 0; i < numericData.size(); i++) {
-            int c = labels[i];
-            count[c]++;
-            for (int j = 0; j < numericData[i].size(); j++) {
-                newC[c][j] += numericData[i][j];
+        int T = pool.size();
+        auto work = [&](int t) {
+            size_t begin = n * t / T, end = n * (t + 1) / T;
+            long long evals = 0;
+            clearAccumulators(t);
+            for (size_t i = begin; i < end; i++) {
+                if (first) scanAll(i, evals);
+                else if (algorithm == ELKAN) elkanPoint(i, evals);
+                else hamerlyPoint(i, evals);
+                bestDist2[i] = upper[i] * upper[i];
+                accumulate(t, i);
             }
-        }
+            threadEvals[t] = evals;
+        };
+        pool.run(work);
+        for (int t = 0; t < T; t++) distEvaluated += threadEvals[t];
+        distPossible += (long long)n * k;
+
+        if (verbose) printAssignments();
+        reduceCentroids(T);
 
+        // Centroid drift feeds the bound updates of the next iteration
+        maxDrift = secondDrift = 0;
+        maxDriftIdx = -1;
         for (int c = 0; c < k; c++) {
-            if (count[c] == 0) continue;
-            for (int j = 0; j < newC[c].size(); j++) {
-                newC[c][j] /= count[c];
+            drift[c] = euclidDist(&prevCentroids[c * d], &centroids[c * d]);
+            if (drift[c] > maxDrift) {
+                secondDrift = maxDrift;
+                maxDrift = drift[c];
+                maxDriftIdx = c;
+            } else if (drift[c] > secondDrift) {
+                secondDrift = drift[c];
             }
         }
+        if (verbose) printCentroids();
+    }
+
+    // --- Mini-batch step on m rows (Sculley): assign against fixed centroids, then move
+    // each centroid towards its points with learning rate 1 / (samples seen so far) ---
+    void miniBatchUpdate(const double* X, const double* xNorms, size_t m) {
+        kernel.setCentroids(centroids.data(), k, d);
+        batchLabels.resize(m);
+        Parallel::forRange(m, Parallel::resolveThreads(numThreads, max<size_t>(1, m / 1024)),
+                           [&](size_t b, size_t e, int) {
+                               kernel.assign(X, xNorms, b, e, batchLabels.data(), nullptr);
+                           });
 
-        centroids = newC;
-        printCentroids();
+        for (size_t i = 0; i < m; i++) {
+            int c = batchLabels[i];
+            double eta = 1.0 / ++centerCounts[c];
+            const double* x = X + i * d;
+            double* cent = centroid(c);
+            for (size_t j = 0; j < d; j++) cent[j] += eta * (x[j] - cent[j]);
+        }
+    }
+
+    void assignAll() {
+        labels.assign(n, -1);
+        bestDist2.assign(n, 0.0);
+        kernel.setCentroids(centroids.data(), k, d);
+        Parallel::forRange(n, Parallel::resolveThreads(numThreads, max<size_t>(1, n / 1024)),
+                           [&](size_t b, size_t e, int) {
+                               kernel.assign(points.data(), pointNorms.data(), b, e, labels.data(), bestDist2.data());
+                           });
     }
 
 public:
-    KMeans(Dataset d, int clusters) {
-        data = d;
-        k = clusters;
-        convertToNumeric();
+    KMeans(const Dataset& data, int clusters) : k(clusters) {
+        convertToNumeric(data);
     }
 
-    void run(int maxIter = 10) {
-        cout << "\nStarting K-Means Clustering (" << k << " clusters, " << maxIter << " iterations max)\n";
+    // Streaming model: no rows are held, centroids are fed through partialFit()
+    explicit KMeans(int clusters) : k(clusters) {}
+
+    void run(int maxIter = 10, bool verbose = true) {
+        this->verbose = verbose;
+        if (n == 0) {
+            cerr << "Error: KMeans has no points loaded." << endl;
+            return;
+        }
+        if (verbose) {
+            cout << "\nStarting K-Means Clustering (" << k << " clusters, " << maxIter << " iterations max)\n";
+            cout << "Assignment kernel: " << KMeansKernel::isaName(kernel.isa) << endl;
+        }
+        rng.seed(seed);
         initCentroids();
+        if (centroids.empty()) return;
+        iterationsRun = 0;
 
-        for (int iter = 1; iter <= maxIter; iter++) {
-            cout << "\n====================== ITERATION " << iter << " ======================\n";
-            assignClusters();
+        Algorithm requested = algorithm;
+        if (algorithm == AUTO_BOUNDS) algorithm = d <= 32 ? HAMERLY : ELKAN;
+        if (verbose && algorithm != LLOYD)
+            cout << "Bounds mode: " << (algorithm == HAMERLY ? "Hamerly" : "Elkan") << endl;
+
+        WorkerPool pool(Parallel::resolveThreads(numThreads, max<size_t>(1, n / 1024)));
+        allocateBuffers(pool.size());
 
-            vector<vector<double>> prevCentroids = centroids;
-            recomputeCentroids();
+        for (int iter = 1; iter <= maxIter; iter++) {
+            if (verbose) cout << "\n====================== ITERATION " << iter << " ======================\n";
+            copy(centroids.begin(), centroids.end(), prevCentroids.begin());
+            if (algorithm == LLOYD) lloydStep(pool);
+            else boundsStep(pool, iter == 1);
+            iterationsRun = iter;
 
             // Check for convergence
             double diff = 0;
             for (int c = 0; c < k; c++) {
-                diff += euclidDist(prevCentroids[c], centroids[c]);
+                diff += euclidDist(&prevCentroids[c * d], centroid(c));
             }
 
-            cout << "\nTotal centroid shift = " << fixed << setprecision(6) << diff << endl;
+            if (verbose) cout << "\nTotal centroid shift = " << fixed << setprecision(6) << diff << endl;
 
             if (diff < 1e-6) {
-                cout << "\nConverged after " << iter << " iterations.\n";
+                if (verbose) cout << "\nConverged after " << iter << " iterations.\n";
                 break;
             }
         }
 
-        cout << "\nFinal Cluster Assignment:\n";
-        for (int i = 0; i < labels.size(); i++) {
-            cout << "  Row " << setw(3) << i << " Cluster " << labels[i] << endl;
+        if (verbose) {
+            cout << "\nFinal Cluster Assignment:\n";
+            for (size_t i = 0; i < labels.size(); i++) {
+                cout << "  Row " << setw(3) << i << " Cluster " << labels[i] << endl;
+            }
+            cout << "=================================================================\n";
+        }
+
+        if (verbose && algorithm != LLOYD) {
+            cout << "Distance computations: " << distEvaluated << " of " << distPossible
+                 << " (" << fixed << setprecision(1) << 100.0 * distSkippedFraction() << "% avoided)\n";
         }
-        cout << "=================================================================\n";
+        algorithm = requested;
+    }
+
+    // --- Mini-batch KMeans over the loaded points (random batches, per-center learning rates) ---
+    void runMiniBatch(size_t batchSize = 1024, int maxIter = 100, bool verbose = true) {
+        this->verbose = verbose;
+        if (n == 0) {
+            cerr << "Error: KMeans has no points loaded." << endl;
+            return;
+        }
+        batchSize = min(batchSize, n);
+        if (verbose)
+            cout << "\nStarting Mini-Batch K-Means (" << k << " clusters, batch " << batchSize
+                 << ", " << maxIter << " iterations max)\n";
+        rng.seed(seed);
+        initCentroids();
+        if (centroids.empty()) return;
+        centerCounts.assign(k, 0);
+        batchPoints.resize(batchSize * d);
+        batchNorms.resize(batchSize);
+        prevCentroids.resize(k * d);
+
+        uniform_int_distribution<size_t> pick(0, n - 1);
+        for (int iter = 1; iter <= maxIter; iter++) {
+            copy(centroids.begin(), centroids.end(), prevCentroids.begin());
+            for (size_t b = 0; b < batchSize; b++) {
+                size_t i = pick(rng);
+                copy(point(i), point(i) + d, &batchPoints[b * d]);
+                batchNorms[b] = pointNorms[i];
+            }
+            miniBatchUpdate(batchPoints.data(), batchNorms.data(), batchSize);
+
+            double diff = 0;
+            for (int c = 0; c < k; c++) diff += euclidDist(&prevCentroids[c * d], centroid(c));
+            if (verbose) cout << "  Iteration " << iter << ": centroid shift = " << fixed << setprecision(6) << diff << endl;
+            if (diff < 1e-6) {
+                if (verbose) cout << "\nConverged after " << iter << " iterations.\n";
+                break;
+            }
+        }
+
+        assignAll();
+        if (verbose) printCentroids();
+    }
+
+    // --- Online update with one batch of rows (e.g. from DatasetStream::next) ---
+    // The first call fixes the dimensionality and seeds the centroids from that batch.
+    void partialFit(const Dataset& batch, bool verbose = false) {
+        this->verbose = verbose;
+        const ColumnStore& cs = batch.columnar();
+        size_t m = cs.nRows;
+        if (m == 0) return;
+        if (centroids.empty()) {
+            if (m < (size_t)k) {
+                cerr << "Error: First batch has " << m << " rows, need at least " << k << " to seed." << endl;
+                return;
+            }
+            warnCategorical(batch);
+            d = cs.numCols();
+        } else if (cs.numCols() != d) {
+            cerr << "Error: Batch has " << cs.numCols() << " columns, expected " << d << endl;
+            return;
+        }
+
+        size_t missing = 0;
+        batchPoints = cs.numericMatrix(&missing);  // means of this batch
+        warnMissing(missing);
+        batchNorms.resize(m);
+        KMeansKernel::rowNorms(batchPoints.data(), m, d, batchNorms.data());
+        if (centroids.empty()) {
+            initCentroids(batchPoints.data(), m);
+            if (centroids.empty()) return;
+            centerCounts.assign(k, 0);
+        }
+        miniBatchUpdate(batchPoints.data(), batchNorms.data(), m);
+    }
+
+    // --- Fit from a chunked reader: epochs passes of partialFit over every batch ---
+    void fit(DatasetStream& stream, int epochs = 1, bool verbose = true) {
+        Dataset batch;
+        size_t batches = 0;
+        for (int e = 0; e < epochs; e++) {
+            stream.reset();
+            while (stream.next(batch)) {
+                partialFit(batch, false);
+                batches++;
+            }
+        }
+        if (verbose) {
+            cout << "\nStreaming K-Means: " << batches << " batches, " << stream.rowsRead()
+                 << " rows per epoch, " << epochs << " epoch(s)\n";
+            printCentroids();
+        }
+    }
+
+    // --- Nearest centroid for each row of a dataset (works for streamed models too) ---
+    vector<int> predict(const Dataset& batch) {
+        const ColumnStore& cs = batch.columnar();
+        if (centroids.empty() || cs.numCols() != d) {
+            cerr << "Error: KMeans is not fitted for " << cs.numCols() << " columns." << endl;
+            return {};
+        }
+        vector<double> X = cs.numericMatrix();
+        vector<double> norms(cs.nRows);
+        KMeansKernel::rowNorms(X.data(), cs.nRows, d, norms.data());
+        vector<int> out(cs.nRows);
+        kernel.setCentroids(centroids.data(), k, d);
+        kernel.assign(X.data(), norms.data(), 0, cs.nRows, out.data(), nullptr);
+        return out;
+    }
+
+    // --- Run Lloyd from every seeding strategy with the same seed and compare ---
+    void compareSeeding(int maxIter = 100) {
+        KMeansSeeding::Method saved = initMethod;
+        cout << "\nSeeding comparison (" << n << " rows, k = " << k << ", seed " << seed << ")\n";
+        cout << "-------------------------------------------------------------\n";
+        cout << left << setw(12) << "Seeding" << right << setw(12) << "Seed ms" << setw(12) << "Iterations"
+             << setw(22) << "Inertia" << endl;
+        for (auto m : {KMeansSeeding::RANDOM, KMeansSeeding::PLUS_PLUS, KMeansSeeding::PARALLEL}) {
+            initMethod = m;
+            run(maxIter, false);
+            cout << left << setw(12) << KMeansSeeding::methodName(m) << right << fixed
+                 << setw(12) << setprecision(1) << seedingMs << setw(12) << iterationsRun
+                 << setw(22) << setprecision(3) << inertia() << endl;
+        }
+        initMethod = saved;
+    }
+
+    // --- Seeding controls: the same seed always gives the same centroids and labels ---
+    void setSeed(uint64_t s) {
+        seed = s;
+        rng.seed(s);
+    }
+    void setInit(KMeansSeeding::Method m) { initMethod = m; }
+    void setSeedingRounds(int rounds, double oversampling = 2.0) {
+        seeding.rounds = rounds;
+        seeding.oversampling = oversampling;
+    }
+
+    int getIterations() const { return iterationsRun; }
+
+    // Sum of squared distances from each point to its assigned centroid
+    double inertia() const {
+        double s = 0;
+        for (double v : bestDist2) s += v;
+        return s;
+    }
+
+    // --- Choose LLOYD, HAMERLY, ELKAN or AUTO_BOUNDS (Hamerly for d <= 32, else Elkan) ---
+    void setAlgorithm(Algorithm a) { algorithm = a; }
+
+    long long distanceEvaluations() const { return distEvaluated; }
+    double distSkippedFraction() const {
+        return distPossible ? 1.0 - (double)distEvaluated / distPossible : 0.0;
     }
 
     vector<int> getLabels() { return labels; }
 
+    void setThreads(int threads) { numThreads = threads; }
+
+    // Force a narrower SIMD path (e.g. to compare against the scalar fallback)
+    void setKernelIsa(KMeansKernel::Isa isa) { kernel.isa = min(isa, KMeansKernel::detect()); }
+
     void printCentroids() {
         cout << "\nCurrent Centroids:\n";
-        for (int i = 0; i < centroids.size(); i++) {
+        for (int i = 0; i < k; i++) {
             cout << "  C" << i << "  ";
-            for (double v : centroids[i])
-                cout << setw(8) << fixed << setprecision(3) << v << " ";
+            for (size_t j = 0; j < d; j++)
+                cout << setw(8) << fixed << setprecision(3) << centroids[i * d + j] << " ";
             cout << endl;
         }
     }
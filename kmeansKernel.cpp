@@ -0,0 +1,217 @@
+#include <bits/stdc++.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KMEANS_X86 1
+#endif
+using namespace std;
+
+// --- Nearest-centroid assignment on flat row-major points ---
+// Squared distances use ||x||^2 - 2 x.c + ||c||^2, so the inner loop is a small GEMM
+// between a block of 4 points and a tile of centroids read from a transposed block.
+// The SIMD width is chosen at runtime (AVX-512 / AVX2+FMA / scalar).
+class KMeansKernel {
+public:
+    enum Isa { SCALAR, AVX2, AVX512 };
+
+    Isa isa;
+
+    KMeansKernel() : isa(detect()) {}
+
+    static Isa detect() {
+#ifdef KMEANS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return AVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return AVX2;
+#endif
+        return SCALAR;
+    }
+
+    static const char* isaName(Isa i) {
+        return i == AVX512 ? "AVX-512" : i == AVX2 ? "AVX2" : "scalar";
+    }
+
+    // Squared norm of every row of an n x d matrix
+    static void rowNorms(const double* X, size_t n, size_t d, double* out) {
+        for (size_t i = 0; i < n; i++) {
+            double s = 0;
+            const double* x = X + i * d;
+            for (size_t j = 0; j < d; j++) s += x[j] * x[j];
+            out[i] = s;
+        }
+    }
+
+    // --- Load centroids (k x d, row-major); call once per iteration ---
+    void setCentroids(const double* C, size_t clusters, size_t dims) {
+        k = clusters;
+        d = dims;
+        kPad = (k + TILE - 1) / TILE * TILE;
+        ct.assign(d * kPad, 0.0);
+        cNorms.assign(kPad, INFINITY);  // padded centroids can never win
+        for (size_t c = 0; c < k; c++) {
+            double s = 0;
+            for (size_t j = 0; j < d; j++) {
+                double v = C[c * d + j];
+                ct[j * kPad + c] = v;
+                s += v * v;
+            }
+            cNorms[c] = s;
+        }
+    }
+
+    // --- Assign rows [begin, end); safe to call from several threads at once ---
+    // dist2 receives the squared distance to the chosen centroid (may be null).
+    void assign(const double* X, const double* xNorms, size_t begin, size_t end,
+                int* labels, double* dist2) const {
+        size_t blockEnd = begin + (end - begin) / ROWS * ROWS;
+#ifdef KMEANS_X86
+        if (isa == AVX512) assignAvx512(X, xNorms, begin, blockEnd, labels, dist2);
+        else if (isa == AVX2) assignAvx2(X, xNorms, begin, blockEnd, labels, dist2);
+        else assignScalar(X, xNorms, begin, blockEnd, labels, dist2);
+#else
+        assignScalar(X, xNorms, begin, blockEnd, labels, dist2);
+#endif
+        assignScalar(X, xNorms, blockEnd, end, labels, dist2);
+    }
+
+private:
+    static constexpr size_t ROWS = 4;   // points per register block
+    static constexpr size_t TILE = 16;  // centroids per tile (multiple of every SIMD width)
+
+    size_t k = 0, d = 0, kPad = 0;
+    vector<double> ct;      // d x kPad, transposed centroids
+    vector<double> cNorms;  // kPad squared norms (+inf for padding)
+
+    // Keep the first (lowest index) minimum, same as a plain argmin loop
+    static void pickBest(const double* tile, size_t c0, size_t width, double& best, int& bestC) {
+        for (size_t l = 0; l < width; l++)
+            if (tile[l] < best) {
+                best = tile[l];
+                bestC = (int)(c0 + l);
+            }
+    }
+
+    void finish(size_t i, double best, int bestC, const double* xNorms, int* labels, double* dist2) const {
+        labels[i] = bestC;
+        if (dist2) dist2[i] = max(0.0, best + xNorms[i]);
+    }
+
+    void assignScalar(const double* X, const double* xNorms, size_t begin, size_t end,
+                      int* labels, double* dist2) const {
+        double acc[TILE];
+        for (size_t i = begin; i < end; i++) {
+            const double* x = X + i * d;
+            double best = INFINITY;
+            int bestC = 0;
+            for (size_t c = 0; c < kPad; c += TILE) {
+                for (size_t l = 0; l < TILE; l++) acc[l] = 0;
+                for (size_t j = 0; j < d; j++) {
+                    const double* col = &ct[j * kPad + c];
+                    for (size_t l = 0; l < TILE; l++) acc[l] += x[j] * col[l];
+                }
+                for (size_t l = 0; l < TILE; l++) acc[l] = cNorms[c + l] - 2.0 * acc[l];
+                pickBest(acc, c, TILE, best, bestC);
+            }
+            finish(i, best, bestC, xNorms, labels, dist2);
+        }
+    }
+
+#ifdef KMEANS_X86
+    __attribute__((target("avx2,fma")))
+    void assignAvx2(const double* X, const double* xNorms, size_t begin, size_t end,
+                    int* labels, double* dist2) const {
+        alignas(32) double tile[ROWS][8];
+        const __m256d minus2 = _mm256_set1_pd(-2.0);
+
+        for (size_t i = begin; i < end; i += ROWS) {
+            const double* x0 = X + i * d;
+            const double* x1 = x0 + d;
+            const double* x2 = x1 + d;
+            const double* x3 = x2 + d;
+            double best[ROWS] = {INFINITY, INFINITY, INFINITY, INFINITY};
+            int bestC[ROWS] = {0, 0, 0, 0};
+
+            for (size_t c = 0; c < kPad; c += 8) {
+                __m256d a00 = _mm256_setzero_pd(), a01 = _mm256_setzero_pd();
+                __m256d a10 = _mm256_setzero_pd(), a11 = _mm256_setzero_pd();
+                __m256d a20 = _mm256_setzero_pd(), a21 = _mm256_setzero_pd();
+                __m256d a30 = _mm256_setzero_pd(), a31 = _mm256_setzero_pd();
+
+                for (size_t j = 0; j < d; j++) {
+                    const double* col = &ct[j * kPad + c];
+                    __m256d c0 = _mm256_loadu_pd(col), c1 = _mm256_loadu_pd(col + 4);
+                    __m256d v;
+                    v = _mm256_broadcast_sd(x0 + j);
+                    a00 = _mm256_fmadd_pd(v, c0, a00); a01 = _mm256_fmadd_pd(v, c1, a01);
+                    v = _mm256_broadcast_sd(x1 + j);
+                    a10 = _mm256_fmadd_pd(v, c0, a10); a11 = _mm256_fmadd_pd(v, c1, a11);
+                    v = _mm256_broadcast_sd(x2 + j);
+                    a20 = _mm256_fmadd_pd(v, c0, a20); a21 = _mm256_fmadd_pd(v, c1, a21);
+                    v = _mm256_broadcast_sd(x3 + j);
+                    a30 = _mm256_fmadd_pd(v, c0, a30); a31 = _mm256_fmadd_pd(v, c1, a31);
+                }
+
+                __m256d n0 = _mm256_loadu_pd(&cNorms[c]), n1 = _mm256_loadu_pd(&cNorms[c + 4]);
+                _mm256_store_pd(tile[0], _mm256_fmadd_pd(minus2, a00, n0));
+                _mm256_store_pd(tile[0] + 4, _mm256_fmadd_pd(minus2, a01, n1));
+                _mm256_store_pd(tile[1], _mm256_fmadd_pd(minus2, a10, n0));
+                _mm256_store_pd(tile[1] + 4, _mm256_fmadd_pd(minus2, a11, n1));
+                _mm256_store_pd(tile[2], _mm256_fmadd_pd(minus2, a20, n0));
+                _mm256_store_pd(tile[2] + 4, _mm256_fmadd_pd(minus2, a21, n1));
+                _mm256_store_pd(tile[3], _mm256_fmadd_pd(minus2, a30, n0));
+                _mm256_store_pd(tile[3] + 4, _mm256_fmadd_pd(minus2, a31, n1));
+                for (size_t r = 0; r < ROWS; r++) pickBest(tile[r], c, 8, best[r], bestC[r]);
+            }
+            for (size_t r = 0; r < ROWS; r++) finish(i + r, best[r], bestC[r], xNorms, labels, dist2);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void assignAvx512(const double* X, const double* xNorms, size_t begin, size_t end,
+                      int* labels, double* dist2) const {
+        alignas(64) double tile[ROWS][16];
+        const __m512d minus2 = _mm512_set1_pd(-2.0);
+
+        for (size_t i = begin; i < end; i += ROWS) {
+            const double* x0 = X + i * d;
+            const double* x1 = x0 + d;
+            const double* x2 = x1 + d;
+            const double* x3 = x2 + d;
+            double best[ROWS] = {INFINITY, INFINITY, INFINITY, INFINITY};
+            int bestC[ROWS] = {0, 0, 0, 0};
+
+            for (size_t c = 0; c < kPad; c += 16) {
+                __m512d a00 = _mm512_setzero_pd(), a01 = _mm512_setzero_pd();
+                __m512d a10 = _mm512_setzero_pd(), a11 = _mm512_setzero_pd();
+                __m512d a20 = _mm512_setzero_pd(), a21 = _mm512_setzero_pd();
+                __m512d a30 = _mm512_setzero_pd(), a31 = _mm512_setzero_pd();
+
+                for (size_t j = 0; j < d; j++) {
+                    const double* col = &ct[j * kPad + c];
+                    __m512d c0 = _mm512_loadu_pd(col), c1 = _mm512_loadu_pd(col + 8);
+                    __m512d v;
+                    v = _mm512_set1_pd(x0[j]);
+                    a00 = _mm512_fmadd_pd(v, c0, a00); a01 = _mm512_fmadd_pd(v, c1, a01);
+                    v = _mm512_set1_pd(x1[j]);
+                    a10 = _mm512_fmadd_pd(v, c0, a10); a11 = _mm512_fmadd_pd(v, c1, a11);
+                    v = _mm512_set1_pd(x2[j]);
+                    a20 = _mm512_fmadd_pd(v, c0, a20); a21 = _mm512_fmadd_pd(v, c1, a21);
+                    v = _mm512_set1_pd(x3[j]);
+                    a30 = _mm512_fmadd_pd(v, c0, a30); a31 = _mm512_fmadd_pd(v, c1, a31);
+                }
+
+                __m512d n0 = _mm512_loadu_pd(&cNorms[c]), n1 = _mm512_loadu_pd(&cNorms[c + 8]);
+                _mm512_store_pd(tile[0], _mm512_fmadd_pd(minus2, a00, n0));
+                _mm512_store_pd(tile[0] + 8, _mm512_fmadd_pd(minus2, a01, n1));
+                _mm512_store_pd(tile[1], _mm512_fmadd_pd(minus2, a10, n0));
+                _mm512_store_pd(tile[1] + 8, _mm512_fmadd_pd(minus2, a11, n1));
+                _mm512_store_pd(tile[2], _mm512_fmadd_pd(minus2, a20, n0));
+                _mm512_store_pd(tile[2] + 8, _mm512_fmadd_pd(minus2, a21, n1));
+                _mm512_store_pd(tile[3], _mm512_fmadd_pd(minus2, a30, n0));
+                _mm512_store_pd(tile[3] + 8, _mm512_fmadd_pd(minus2, a31, n1));
+                for (size_t r = 0; r < ROWS; r++) pickBest(tile[r], c, 16, best[r], bestC[r]);
+            }
+            for (size_t r = 0; r < ROWS; r++) finish(i + r, best[r], bestC[r], xNorms, labels, dist2);
+        }
+    }
+#endif
+};
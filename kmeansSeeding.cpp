@@ -0,0 +1,212 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// --- Initial centroids for KMeans ---
+// RANDOM    : k distinct rows
+// PLUS_PLUS : k-means++ (each new centroid drawn with probability ~ D(x)^2)
+// PARALLEL  : k-means|| (a few oversampling rounds over all rows, run in parallel,
+//             then the weighted candidates are reduced to k with k-means++ + Lloyd)
+// All draws come from the caller's RNG and parallel work is split into fixed blocks,
+// so the same seed gives the same centroids whatever the thread count.
+class KMeansSeeding {
+public:
+    enum Method { RANDOM, PLUS_PLUS, PARALLEL };
+
+    int numThreads = 0;         // 0 = hardware concurrency
+    int rounds = 5;             // k-means|| oversampling rounds
+    double oversampling = 2.0;  // expected candidates per round = oversampling * k
+
+    static const char* methodName(Method m) {
+        return m == RANDOM ? "random" : m == PLUS_PLUS ? "k-means++" : "k-means||";
+    }
+
+    // Returns k x d centroids (row-major) picked from the n x d matrix X
+    vector<double> seed(Method method, const double* X, size_t n, size_t d, int k, mt19937_64& rng) const {
+        if (k <= 0 || n < (size_t)k) {
+            cerr << "Error: Cannot pick " << k << " centroids from " << n << " rows." << endl;
+            return {};
+        }
+        if (method == RANDOM) return randomRows(X, n, d, k, rng);
+        if (method == PLUS_PLUS) return plusPlus(X, nullptr, n, d, k, rng);
+        return parallelSeed(X, n, d, k, rng);
+    }
+
+private:
+    static constexpr size_t BLOCK = 4096;  // rows per parallel block
+    static constexpr int RECLUSTER_STEPS = 10;
+
+    static vector<double> randomRows(const double* X, size_t n, size_t d, int k, mt19937_64& rng) {
+        uniform_int_distribution<size_t> pick(0, n - 1);
+        unordered_set<size_t> used;
+        vector<double> C;
+        while (used.size() < (size_t)k) {
+            size_t idx = pick(rng);
+            if (used.insert(idx).second) C.insert(C.end(), X + idx * d, X + (idx + 1) * d);
+        }
+        return C;
+    }
+
+    // Lower minD against centroids [from, to) of C; returns sum of w * minD.
+    // Block sums are added in block order so the total does not depend on threads.
+    double updateMinDist(const double* X, const double* w, size_t n, size_t d,
+                         const vector<double>& C, size_t from, size_t to, vector<double>& minD) const {
+        size_t nBlocks = (n + BLOCK - 1) / BLOCK;
+        vector<double> blockSums(nBlocks, 0.0);
+        DistanceKernel kernel(DistanceKernel::SQEUCLIDEAN);
+        Parallel::forBlocks(n, BLOCK, numThreads, [&](size_t b, size_t e, int) {
+            // New centroids in chunks of 64 columns to bound the distance buffer
+            vector<double> dist((e - b) * 64);
+            for (size_t c0 = from; c0 < to; c0 += 64) {
+                size_t c1 = min(to, c0 + 64);
+                kernel.block(X, b, e, C.data(), c0, c1, d, dist.data(), 64);
+                for (size_t i = b; i < e; i++)
+                    for (size_t c = c0; c < c1; c++) minD[i] = min(minD[i], dist[(i - b) * 64 + (c - c0)]);
+            }
+            double s = 0;
+            for (size_t i = b; i < e; i++) s += w ? w[i] * minD[i] : minD[i];
+            blockSums[b / BLOCK] = s;
+        });
+        double total = 0;
+        for (double s : blockSums) total += s;
+        return total;
+    }
+
+    // k-means++ on (optionally weighted) rows
+    vector<double> plusPlus(const double* X, const double* w, size_t n, size_t d, int k, mt19937_64& rng) const {
+        vector<double> C;
+        C.reserve(k * d);
+        vector<double> minD(n, INFINITY);
+
+        size_t first;
+        if (w) {
+            double total = 0;
+            for (size_t i = 0; i < n; i++) total += w[i];
+            first = sample(w, nullptr, n, total, rng);
+        } else {
+            first = uniform_int_distribution<size_t>(0, n - 1)(rng);
+        }
+        C.insert(C.end(), X + first * d, X + (first + 1) * d);
+
+        for (int c = 1; c < k; c++) {
+            double total = updateMinDist(X, w, n, d, C, c - 1, c, minD);
+            size_t idx = total > 0 ? sample(w, minD.data(), n, total, rng)
+                                   : uniform_int_distribution<size_t>(0, n - 1)(rng);  // all rows covered
+            C.insert(C.end(), X + idx * d, X + (idx + 1) * d);
+        }
+        return C;
+    }
+
+    // Index drawn with probability w[i] * p[i] / total (either array may be null = 1)
+    static size_t sample(const double* w, const double* p, size_t n, double total, mt19937_64& rng) {
+        double r = uniform_real_distribution<double>(0, total)(rng);
+        double acc = 0;
+        size_t last = 0;
+        for (size_t i = 0; i < n; i++) {
+            double v = (w ? w[i] : 1.0) * (p ? p[i] : 1.0);
+            if (v <= 0) continue;
+            acc += v;
+            last = i;
+            if (acc > r) return i;
+        }
+        return last;  // rounding at the very end of the scan
+    }
+
+    vector<double> parallelSeed(const double* X, size_t n, size_t d, int k, mt19937_64& rng) const {
+        vector<double> C;
+        vector<double> minD(n, INFINITY);
+        size_t first = uniform_int_distribution<size_t>(0, n - 1)(rng);
+        C.insert(C.end(), X + first * d, X + (first + 1) * d);
+        unordered_set<size_t> chosen = {first};
+        double phi = updateMinDist(X, nullptr, n, d, C, 0, 1, minD);
+
+        // Oversampling: every row joins independently with probability l * D^2 / phi.
+        // Each block draws from its own generator seeded from rng, in block order.
+        double l = oversampling * k;
+        size_t nBlocks = (n + BLOCK - 1) / BLOCK;
+        for (int round = 0; round < rounds && phi > 0; round++) {
+            uint64_t roundSeed = rng();
+            vector<vector<size_t>> picked(nBlocks);
+            Parallel::forBlocks(n, BLOCK, numThreads, [&](size_t b, size_t e, int) {
+                mt19937_64 g(roundSeed + 0x9E3779B97F4A7C15ULL * (b / BLOCK + 1));
+                uniform_real_distribution<double> u(0, 1);
+                for (size_t i = b; i < e; i++)
+                    if (u(g) * phi < l * minD[i]) picked[b / BLOCK].push_back(i);
+            });
+
+            size_t before = C.size() / d;
+            for (auto& block : picked)
+                for (size_t i : block) {
+                    C.insert(C.end(), X + i * d, X + (i + 1) * d);
+                    chosen.insert(i);
+                }
+            phi = updateMinDist(X, nullptr, n, d, C, before, C.size() / d, minD);
+        }
+
+        size_t m = C.size() / d;
+        if (m <= (size_t)k) {
+            // Too few candidates (tiny or duplicate-heavy data): top up with D^2 draws against
+            // the current centres, so no row equal to a centre is drawn. Once every row
+            // coincides with a centre, fall back to rows not chosen yet.
+            uniform_int_distribution<size_t> pick(0, n - 1);
+            for (; m < (size_t)k; m++) {
+                size_t idx;
+                if (phi > 0) {
+                    idx = sample(nullptr, minD.data(), n, phi, rng);
+                } else {
+                    do idx = pick(rng);
+                    while (chosen.count(idx));
+                }
+                chosen.insert(idx);
+                C.insert(C.end(), X + idx * d, X + (idx + 1) * d);
+                phi = updateMinDist(X, nullptr, n, d, C, m, m + 1, minD);
+            }
+            return C;
+        }
+
+        // Weight each candidate by the number of rows closest to it
+        vector<double> xNorms(n);
+        KMeansKernel::rowNorms(X, n, d, xNorms.data());
+        KMeansKernel kernel;
+        kernel.setCentroids(C.data(), m, d);
+        vector<int> nearest(n);
+        int T = Parallel::resolveThreads(numThreads, (n + BLOCK - 1) / BLOCK);
+        vector<vector<double>> threadWeights(T, vector<double>(m, 0.0));
+        Parallel::forRange(n, T, [&](size_t b, size_t e, int t) {
+            kernel.assign(X, xNorms.data(), b, e, nearest.data(), nullptr);
+            for (size_t i = b; i < e; i++) threadWeights[t][nearest[i]] += 1;
+        });
+        for (int t = 1; t < T; t++)
+            for (size_t c = 0; c < m; c++) threadWeights[0][c] += threadWeights[t][c];
+
+        return recluster(C, threadWeights[0], m, d, k, rng);
+    }
+
+    // Weighted k-means++ followed by a few weighted Lloyd steps on the candidates
+    vector<double> recluster(const vector<double>& P, const vector<double>& w, size_t m, size_t d,
+                             int k, mt19937_64& rng) const {
+        vector<double> C = plusPlus(P.data(), w.data(), m, d, k, rng);
+        vector<double> sums(k * d);
+        vector<double> mass(k);
+        for (int step = 0; step < RECLUSTER_STEPS; step++) {
+            fill(sums.begin(), sums.end(), 0.0);
+            fill(mass.begin(), mass.end(), 0.0);
+            for (size_t i = 0; i < m; i++) {
+                int best = 0;
+                double bestD = INFINITY;
+                for (int c = 0; c < k; c++) {
+                    double dd = DistanceKernel::sqEuclidean(&P[i * d], &C[c * d], d);
+                    if (dd < bestD) {
+                        bestD = dd;
+                        best = c;
+                    }
+                }
+                mass[best] += w[i];
+                for (size_t j = 0; j < d; j++) sums[best * d + j] += w[i] * P[i * d + j];
+            }
+            for (int c = 0; c < k; c++)
+                if (mass[c] > 0)
+                    for (size_t j = 0; j < d; j++) C[c * d + j] = sums[c * d + j] / mass[c];
+        }
+        return C;
+    }
+};
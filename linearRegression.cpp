@@ -1,7 +1,207 @@
 #include <bits/stdc++.h>
 using namespace std;
 
+// --- Sufficient statistics for least squares on d features plus the target ---
+// Means and centred co-moments of z = (x_1..x_d, y). Each block of rows is centred on its
+// own mean before cross products are summed, and blocks / threads are combined with
+// Chan's formula, so large offsets do not swamp the result the way raw sums of x*y do.
+struct RegressionMoments {
+    size_t dims = 1;             // d + 1
+    long long count = 0;
+    vector<double> mean;         // dims
+    vector<double> comoment;     // dims x dims, upper triangle (i <= j) filled
+
+    explicit RegressionMoments(size_t features = 0) { reset(features); }
+
+    void reset(size_t features) {
+        dims = features + 1;
+        count = 0;
+        mean.assign(dims, 0.0);
+        comoment.assign(dims * dims, 0.0);
+    }
+
+    double at(size_t i, size_t j) const { return i <= j ? comoment[i * dims + j] : comoment[j * dims + i]; }
+
+    // Add m rows given as an m x dims row-major block (features, then target)
+    void addBlock(const double* Z, size_t m) {
+        if (m == 0) return;
+        RegressionMoments b(dims - 1);
+        b.count = m;
+        for (size_t r = 0; r < m; r++)
+            for (size_t i = 0; i < dims; i++) b.mean[i] += Z[r * dims + i];
+        for (size_t i = 0; i < dims; i++) b.mean[i] /= m;
+
+        vector<double> dz(dims);
+        for (size_t r = 0; r < m; r++) {
+            for (size_t i = 0; i < dims; i++) dz[i] = Z[r * dims + i] - b.mean[i];
+            for (size_t i = 0; i < dims; i++) {
+                double di = dz[i];
+                double* row = &b.comoment[i * dims];
+                for (size_t j = i; j < dims; j++) row[j] += di * dz[j];
+            }
+        }
+        merge(b);
+    }
+
+    // Combine with moments gathered over a disjoint set of rows (Chan et al.)
+    void merge(const RegressionMoments& o) {
+        if (o.count == 0) return;
+        if (count == 0) { *this = o; return; }
+        long long n = count + o.count;
+        double w = (double)count * o.count / n;
+        vector<double> delta(dims);
+        for (size_t i = 0; i < dims; i++) delta[i] = o.mean[i] - mean[i];
+        for (size_t i = 0; i < dims; i++)
+            for (size_t j = i; j < dims; j++)
+                comoment[i * dims + j] += o.comoment[i * dims + j] + delta[i] * delta[j] * w;
+        for (size_t i = 0; i < dims; i++) mean[i] += delta[i] * o.count / n;
+        count = n;
+    }
+};
+
+// --- y = b + w . x over a block of row-major rows (split across threads when large) ---
+// The model is checked once per call, not once per row.
+struct LinearScorer {
+    static void score(const double* X, size_t rows, size_t d, const double* w, double b, double* out,
+                      int threads = 0) {
+        int T = Parallel::resolveThreads(threads, max<size_t>(1, rows / 65536));
+        Parallel::forRange(rows, T, [&](size_t begin, size_t end, int) {
+            for (size_t i = begin; i < end; i++) {
+                const double* x = X + i * d;
+                double acc = b;
+                for (size_t j = 0; j < d; j++) acc += w[j] * x[j];
+                out[i] = acc;
+            }
+        });
+    }
+};
+
+// --- Compensated (Kahan-Babuska) sum; partial sums merge without losing the low bits ---
+struct KahanSum {
+    double sum = 0.0, comp = 0.0;
+
+    void add(double x) {
+        double t = sum + x;
+        if (fabs(sum) >= fabs(x)) comp += (sum - t) + x;
+        else comp += (x - t) + sum;
+        sum = t;
+    }
+
+    void merge(const KahanSum& o) {
+        add(o.sum);
+        comp += o.comp;
+    }
+
+    double value() const { return sum + comp; }
+};
+
+// --- Goodness of fit from one pass over (prediction, target) pairs ---
+struct RegressionMetrics {
+    static constexpr double QUANTILES[5] = {0.05, 0.25, 0.5, 0.75, 0.95};
+
+    long long count = 0;
+    double sst = 0.0, ssr = 0.0;
+    double mse = NAN, rmse = NAN, mae = NAN, r2 = NAN;
+    vector<double> residualQuantiles;  // residual (actual - predicted) at QUANTILES
+
+    void print(const string& title = "Model Evaluation") const {
+        cout << "\n" << title << "\n";
+        cout << string(title.size(), '-') << "\n";
+        cout << "Rows evaluated             : " << count << endl;
+        cout << "Total Sum of Squares (SST) : " << sst << endl;
+        cout << "Residual Sum of Squares (SSR): " << ssr << endl;
+        cout << "R^2 Score                  : " << r2 << endl;
+        cout << "MSE                        : " << mse << endl;
+        cout << "RMSE                       : " << rmse << endl;
+        if (!std::isnan(mae)) cout << "MAE                        : " << mae << endl;
+        if (!residualQuantiles.empty()) {
+            cout << "Residual quantiles         :";
+            for (size_t q = 0; q < residualQuantiles.size(); q++)
+                cout << "  p" << (int)(QUANTILES[q] * 100) << "=" << residualQuantiles[q];
+            cout << endl;
+        }
+    }
+
+    // Fills the derived fields from the sums
+    void finish(double absSum) {
+        if (count == 0) return;
+        mse = ssr / count;
+        rmse = sqrt(mse);
+        mae = absSum / count;
+        r2 = sst > 0 ? 1 - ssr / sst : NAN;
+    }
+};
+
+class RegressionEvaluator {
+public:
+    // --- Fused pass: pair(i, pred, actual) fills one row and returns false to skip it ---
+    // Per-thread Welford statistics of the target (SST) and compensated sums of squared and
+    // absolute residuals are merged at the end; residuals are kept as floats for the
+    // quantiles, which cost one nth_element each.
+    template <class F>
+    static RegressionMetrics run(size_t n, int threads, F pair) {
+        struct Partial {
+            ColumnStats target;
+            KahanSum sq, abs;
+        };
+        int T = Parallel::resolveThreads(threads, max<size_t>(1, n / 16384));
+        vector<Partial> partial(T);
+        vector<float> residuals(n);
+        Parallel::forRange(n, T, [&](size_t b, size_t e, int t) {
+            Partial& p = partial[t];
+            for (size_t i = b; i < e; i++) {
+                double pred, actual;
+                if (!pair(i, pred, actual)) {
+                    residuals[i] = NAN;
+                    continue;
+                }
+                double r = actual - pred;
+                residuals[i] = (float)r;
+                p.target.add(actual);
+                p.sq.add(r * r);
+                p.abs.add(fabs(r));
+            }
+        });
+
+        ColumnStats target;
+        KahanSum sq, abs;
+        for (auto& p : partial) {
+            target.merge(p.target);
+            sq.merge(p.sq);
+            abs.merge(p.abs);
+        }
+
+        RegressionMetrics m;
+        m.count = target.count;
+        m.sst = target.m2;
+        m.ssr = sq.value();
+        m.finish(abs.value());
+
+        residuals.erase(remove_if(residuals.begin(), residuals.end(), [](float r) { return std::isnan(r); }),
+                        residuals.end());
+        if (!residuals.empty())
+            for (double q : RegressionMetrics::QUANTILES) {
+                auto it = residuals.begin() + (size_t)(q * (residuals.size() - 1));
+                nth_element(residuals.begin(), it, residuals.end());
+                m.residualQuantiles.push_back(*it);
+            }
+        return m;
+    }
+
+    // Predictions and targets already in arrays (e.g. from predictBatch)
+    static RegressionMetrics run(const double* pred, const double* actual, size_t n, int threads = 0) {
+        return run(n, threads, [&](size_t i, double& p, double& a) {
+            p = pred[i];
+            a = actual[i];
+            return true;
+        });
+    }
+};
+
 class LinearRegression {
+public:
+    enum Solver { CHOLESKY, QR };
+
 private:
     Dataset data;
     vector<double> X, Y;
@@ -9,6 +209,14 @@ private:
     double intercept = 0.0;
     bool trained = false;
 
+    // Multivariate model: y = intercept + coef . x
+    vector<double> coef;
+    double ridge = 0.0;        // L2 penalty on coef (not on the intercept)
+    Solver solver = CHOLESKY;
+    int numThreads = 0;        // 0 = hardware concurrency
+    static constexpr size_t BLOCK = 1024;  // rows centred together
+    static constexpr double PIVOT_TOL = 1e-12;
+
     void extractColumns(int xCol, int yCol) {
         for (auto &row : data.rows) {
             if (xCol < row.size() && yCol < row.size()) {
@@ -22,9 +230,253 @@ private:
         }
     }
 
+    static bool parseNumber(const vector<string>& row, int col, double& out) {
+        if (col >= (int)row.size() || row[col].empty()) return false;
+        char* end = 0;
+        out = strtod(row[col].c_str(), &end);
+        return !*end;
+    }
+
+    static bool validColumns(size_t nCols, const vector<int>& xColumns, int yColumn) {
+        if (xColumns.empty()) {
+            cerr << "Error: No feature columns given." << endl;
+            return false;
+        }
+        for (int c : xColumns)
+            if (c < 0 || c >= (int)nCols) {
+                cerr << "Error: Feature column " << c << " out of range." << endl;
+                return false;
+            }
+        if (yColumn < 0 || yColumn >= (int)nCols) {
+            cerr << "Error: Target column " << yColumn << " out of range." << endl;
+            return false;
+        }
+        return true;
+    }
+
+    // --- Solve (Cxx + ridge I) coef = cxy on the centred moments ---
+    // Columns are scaled to a unit diagonal first, which keeps the factorisation accurate
+    // when features differ widely in scale. The intercept then restores the means.
+    void solveMoments(const RegressionMoments& mo) {
+        solveInto(mo, coef, intercept);
+        slope = coef.size() == 1 ? coef[0] : 0.0;
+        trained = true;
+    }
+
+    void solveInto(const RegressionMoments& mo, vector<double>& c, double& b0) const {
+        size_t d = mo.dims - 1;
+        vector<double> scale(d), A(d * d), b(d);
+        for (size_t j = 0; j < d; j++) {
+            scale[j] = sqrt(mo.at(j, j) + ridge);
+            if (scale[j] == 0) scale[j] = 1;  // constant column, no ridge
+        }
+        for (size_t i = 0; i < d; i++) {
+            for (size_t j = 0; j < d; j++)
+                A[i * d + j] = (mo.at(i, j) + (i == j ? ridge : 0.0)) / (scale[i] * scale[j]);
+            b[i] = mo.at(i, d) / scale[i];
+        }
+
+        vector<double> z = b;
+        if (solver == QR || !choleskySolve(A, z, d)) {
+            if (solver == CHOLESKY)
+                cerr << "Warning: Normal equations are singular (collinear or constant features); "
+                     << "using pivoted QR." << endl;
+            z = b;
+            pivotedQRSolve(A, z, d);
+        }
+
+        c.assign(d, 0.0);
+        b0 = mo.mean[d];
+        for (size_t j = 0; j < d; j++) {
+            c[j] = z[j] / scale[j];
+            b0 -= c[j] * mo.mean[j];
+        }
+    }
+
+    // Cholesky solve of the symmetric positive definite system A z = b (z holds b on entry).
+    // False when a pivot is not clearly positive, i.e. the features are (nearly) collinear.
+    static bool choleskySolve(vector<double> A, vector<double>& z, size_t d) {
+        for (size_t j = 0; j < d; j++) {
+            double s = A[j * d + j];
+            for (size_t k = 0; k < j; k++) s -= A[j * d + k] * A[j * d + k];
+            if (!(s > PIVOT_TOL)) return false;
+            double l = sqrt(s);
+            A[j * d + j] = l;
+            for (size_t i = j + 1; i < d; i++) {
+                double v = A[i * d + j];
+                for (size_t k = 0; k < j; k++) v -= A[i * d + k] * A[j * d + k];
+                A[i * d + j] = v / l;
+            }
+        }
+        for (size_t i = 0; i < d; i++) {
+            for (size_t k = 0; k < i; k++) z[i] -= A[i * d + k] * z[k];
+            z[i] /= A[i * d + i];
+        }
+        for (size_t i = d; i-- > 0;) {
+            for (size_t k = i + 1; k < d; k++) z[i] -= A[k * d + i] * z[k];
+            z[i] /= A[i * d + i];
+        }
+        return true;
+    }
+
+    // Householder QR with column pivoting. Columns beyond the numerical rank get a zero
+    // coefficient, so duplicated or constant features still give a usable model.
+    static void pivotedQRSolve(vector<double> A, vector<double>& z, size_t d) {
+        vector<size_t> perm(d);
+        iota(perm.begin(), perm.end(), 0);
+        size_t rank = 0;
+        double firstPivot = 0;
+        for (size_t k = 0; k < d; k++) {
+            size_t p = k;
+            double bestNorm = -1;
+            for (size_t j = k; j < d; j++) {
+                double s = 0;
+                for (size_t i = k; i < d; i++) s += A[i * d + j] * A[i * d + j];
+                if (s > bestNorm) {
+                    bestNorm = s;
+                    p = j;
+                }
+            }
+            if (p != k) {
+                for (size_t i = 0; i < d; i++) swap(A[i * d + k], A[i * d + p]);
+                swap(perm[k], perm[p]);
+            }
+
+            double alpha = sqrt(bestNorm);
+            if (k == 0) firstPivot = alpha;
+            if (alpha <= 1e-10 * firstPivot || alpha == 0) break;
+            if (A[k * d + k] > 0) alpha = -alpha;
+
+            // Reflect rows k.. so column k becomes (alpha, 0, ...)
+            vector<double> v(d - k);
+            for (size_t i = k; i < d; i++) v[i - k] = A[i * d + k];
+            v[0] -= alpha;
+            double vv = 0;
+            for (double x : v) vv += x * x;
+            if (vv > 0) {
+                for (size_t j = k; j < d; j++) {
+                    double dot = 0;
+                    for (size_t i = k; i < d; i++) dot += v[i - k] * A[i * d + j];
+                    double f = 2 * dot / vv;
+                    for (size_t i = k; i < d; i++) A[i * d + j] -= f * v[i - k];
+                }
+                double dot = 0;
+                for (size_t i = k; i < d; i++) dot += v[i - k] * z[i];
+                double f = 2 * dot / vv;
+                for (size_t i = k; i < d; i++) z[i] -= f * v[i - k];
+            }
+            rank = k + 1;
+        }
+
+        vector<double> y(d, 0.0);
+        for (size_t i = rank; i-- > 0;) {
+            double s = z[i];
+            for (size_t j = i + 1; j < rank; j++) s -= A[i * d + j] * y[j];
+            y[i] = s / A[i * d + i];
+        }
+        for (size_t i = 0; i < d; i++) z[perm[i]] = y[i];
+    }
+
+    // Fold of row i for k-fold cross-validation: a fixed hash, so folds are random-looking
+    // but reproducible and need no shuffled index
+    static int foldOf(size_t i, int folds) {
+        uint64_t z = i + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return (int)((z ^ (z >> 31)) % (uint64_t)folds);
+    }
+
+    // --- Moments of each fold in one parallel pass over the columnar views ---
+    // Each thread centres its rows block by block into its own per-fold moments, which are
+    // merged at the end. Rows with a missing value are skipped.
+    vector<RegressionMoments> accumulateFolds(const Dataset& d, const vector<int>& xColumns, int yColumn,
+                                              int folds, long long& skipped) const {
+        const ColumnStore& cs = d.columnar();
+
+        // Views are fetched up front: filling a column's double cache is not thread-safe
+        vector<int> columns = xColumns;
+        columns.push_back(yColumn);
+        vector<NumericView> views;
+        for (int c : columns) {
+            if (cs.cols[c].type == COL_CATEGORICAL)
+                cerr << "Warning: Column '" << d.headers[c] << "' has non-numeric cells; those rows are skipped." << endl;
+            views.push_back(cs.numeric(c));
+        }
+
+        size_t n = cs.nRows, dims = columns.size();
+        int threads = Parallel::resolveThreads(numThreads, max<size_t>(1, n / BLOCK));
+        vector<vector<RegressionMoments>> partial(threads, vector<RegressionMoments>(folds, RegressionMoments(xColumns.size())));
+        vector<long long> skips(threads, 0);
+        Parallel::forRange(n, threads, [&](size_t b, size_t e, int t) {
+            vector<double> Z(folds * BLOCK * dims);
+            vector<size_t> fill(folds, 0);
+            for (size_t i = b; i < e; i++) {
+                int f = folds > 1 ? foldOf(i, folds) : 0;
+                double* z = &Z[(f * BLOCK + fill[f]) * dims];
+                bool ok = true;
+                for (size_t j = 0; j < dims; j++) {
+                    z[j] = views[j][i];
+                    if (std::isnan(z[j])) ok = false;
+                }
+                if (!ok) {
+                    skips[t]++;
+                    continue;
+                }
+                if (++fill[f] == BLOCK) {
+                    partial[t][f].addBlock(&Z[f * BLOCK * dims], BLOCK);
+                    fill[f] = 0;
+                }
+            }
+            for (int f = 0; f < folds; f++) partial[t][f].addBlock(&Z[f * BLOCK * dims], fill[f]);
+        });
+
+        vector<RegressionMoments> total(folds, RegressionMoments(xColumns.size()));
+        for (auto& p : partial)
+            for (int f = 0; f < folds; f++) total[f].merge(p[f]);
+        skipped = accumulate(skips.begin(), skips.end(), 0LL);
+        return total;
+    }
+
+    void finishFit(const RegressionMoments& mo, long long skipped, const vector<string>& names, bool verbose) {
+        if (skipped)
+            cerr << "Warning: " << skipped << " rows with missing or non-numeric values skipped." << endl;
+        if (mo.count == 0) {
+            cerr << "Error: Data columns are empty or invalid." << endl;
+            return;
+        }
+        solveMoments(mo);
+        if (verbose) printSummary(mo, names);
+    }
+
+    void printSummary(const RegressionMoments& mo, const vector<string>& names) const {
+        size_t d = coef.size();
+        cout << "\nLinear Regression Training Summary\n";
+        cout << "-----------------------------------\n";
+        cout << "Number of data points : " << mo.count << endl;
+        cout << "Features              : " << d << endl;
+        if (ridge > 0) cout << "Ridge penalty         : " << ridge << endl;
+        for (size_t j = 0; j < d; j++)
+            cout << "Mean of " << left << setw(14) << names[j] << right << ": " << mo.mean[j] << endl;
+        cout << "Mean of Y             : " << mo.mean[d] << endl;
+        cout << "-----------------------------------\n";
+        if (d == 1) {
+            cout << "Slope (b1)            : " << slope << endl;
+            cout << "Intercept (b0)        : " << intercept << endl;
+            cout << "Equation              : Y = " << intercept << " + " << slope << " * X" << endl;
+        } else {
+            cout << "Intercept (b0)        : " << intercept << endl;
+            for (size_t j = 0; j < d; j++)
+                cout << "Coef " << left << setw(17) << names[j] << right << ": " << coef[j] << endl;
+        }
+        cout << "-----------------------------------\n";
+    }
+
 public:
+    LinearRegression() {}
+
     LinearRegression(Dataset d, int xColumn, int yColumn) {
         data = d;
+        data.materializeRows();
         extractColumns(xColumn, yColumn);
     }
 
@@ -34,72 +486,227 @@ public:
             return;
         }
 
-        int n = X.size();
-        double sumX = accumulate(X.begin(), X.end(), 0.0);
-        double sumY = accumulate(Y.begin(), Y.end(), 0.0);
-        double sumXY = 0.0, sumX2 = 0.0;
-
-        for (int i = 0; i < n; i++) {
-            sumXY += X[i] * Y[i];
-            sumX2 += X[i] * X[i];
+        RegressionMoments mo(1);
+        vector<double> Z(2 * BLOCK);
+        for (size_t b = 0; b < X.size(); b += BLOCK) {
+            size_t m = min(BLOCK, X.size() - b);
+            for (size_t i = 0; i < m; i++) {
+                Z[2 * i] = X[b + i];
+                Z[2 * i + 1] = Y[b + i];
+            }
+            mo.addBlock(Z.data(), m);
         }
+        finishFit(mo, 0, {"X"}, verbose);
+    }
 
-        double meanX = sumX / n;
-        double meanY = sumY / n;
+    // --- Multivariate least squares on any numeric feature columns ---
+    // One parallel pass: each thread centres its rows block by block into its own
+    // moments, which are merged at the end. Rows with a missing value are skipped.
+    void fit(const Dataset& d, const vector<int>& xColumns, int yColumn, bool verbose = true) {
+        if (!validColumns(d.headers.size(), xColumns, yColumn)) return;
+        long long skipped = 0;
+        RegressionMoments total = accumulateFolds(d, xColumns, yColumn, 1, skipped)[0];
+        vector<string> names;
+        for (int c : xColumns) names.push_back(d.headers[c]);
+        finishFit(total, skipped, names, verbose);
+    }
 
-        slope = (n * sumXY - sumX * sumY) / (n * sumX2 - sumX * sumX);
-        intercept = meanY - slope * meanX;
+    // --- Fit from a stream in one pass (rows are not kept in memory) ---
+    // Each batch is parsed and accumulated in parallel; per-thread moments live across
+    // batches, so memory stays at one batch however many rows the file holds.
+    void fit(DatasetStream& stream, const vector<int>& xColumns, int yColumn, bool verbose = true) {
+        if (!validColumns(stream.headers.size(), xColumns, yColumn)) return;
+        vector<int> columns = xColumns;
+        columns.push_back(yColumn);
+        size_t dims = columns.size();
 
-        trained = true;
+        int threads = Parallel::resolveThreads(numThreads, max<size_t>(1, stream.batchRows / BLOCK));
+        vector<RegressionMoments> partial(threads, RegressionMoments(xColumns.size()));
+        vector<long long> skipped(threads, 0);
+        Dataset batch;
 
-        if (verbose) {
-            cout << "\nLinear Regression Training Summary\n";
-            cout << "-----------------------------------\n";
-            cout << "Number of data points : " << n << endl;
-            cout << "Sum of X              : " << sumX << endl;
-            cout << "Sum of Y              : " << sumY << endl;
-            cout << "Sum of X*Y            : " << sumXY << endl;
-            cout << "Sum of X^2            : " << sumX2 << endl;
-            cout << "Mean of X             : " << meanX << endl;
-            cout << "Mean of Y             : " << meanY << endl;
-            cout << "-----------------------------------\n";
-            cout << "Slope (b1)            : " << slope << endl;
-            cout << "Intercept (b0)        : " << intercept << endl;
-            cout << "Equation              : Y = " << intercept << " + " << slope << " * X" << endl;
-            cout << "-----------------------------------\n";
+        stream.reset();
+        while (stream.next(batch)) {
+            Parallel::forRange(batch.rows.size(), threads, [&](size_t b, size_t e, int t) {
+                vector<double> Z(BLOCK * dims);
+                size_t m = 0;
+                for (size_t i = b; i < e; i++) {
+                    double* z = &Z[m * dims];
+                    bool ok = true;
+                    for (size_t j = 0; j < dims && ok; j++) ok = parseNumber(batch.rows[i], columns[j], z[j]);
+                    if (!ok) {
+                        skipped[t]++;
+                        continue;
+                    }
+                    if (++m == BLOCK) {
+                        partial[t].addBlock(Z.data(), m);
+                        m = 0;
+                    }
+                }
+                partial[t].addBlock(Z.data(), m);
+            });
         }
+
+        RegressionMoments total(xColumns.size());
+        for (auto& p : partial) total.merge(p);
+        vector<string> names;
+        for (int c : xColumns) names.push_back(stream.headers[c]);
+        finishFit(total, accumulate(skipped.begin(), skipped.end(), 0LL), names, verbose);
     }
 
+    void fit(DatasetStream& stream, int xColumn, int yColumn, bool verbose = true) {
+        fit(stream, vector<int>{xColumn}, yColumn, verbose);
+    }
+
+    void setRidge(double lambda) { ridge = max(0.0, lambda); }
+    void setSolver(Solver s) { solver = s; }
+    void setThreads(int threads) { numThreads = threads; }
+
+    const vector<double>& getCoefficients() const { return coef; }
+    double getIntercept() const { return intercept; }
+
     double predict(double xVal) {
         if (!trained) {
             cerr << "Error: Model not trained. Call fit() first." << endl;
             return 0.0;
         }
+        if (coef.size() > 1) {
+            cerr << "Error: Model has " << coef.size() << " features; use predict(vector)." << endl;
+            return 0.0;
+        }
         return intercept + slope * xVal;
     }
 
+    double predict(const vector<double>& x) {
+        if (!trained) {
+            cerr << "Error: Model not trained. Call fit() first." << endl;
+            return 0.0;
+        }
+        if (x.size() != coef.size()) {
+            cerr << "Error: Expected " << coef.size() << " features, got " << x.size() << "." << endl;
+            return 0.0;
+        }
+        return intercept + inner_product(coef.begin(), coef.end(), x.begin(), 0.0);
+    }
+
+    // --- Score rows x coef.size() row-major features into out[0..rows) ---
+    void predictBatch(const double* X, size_t rows, double* out) const {
+        if (!trained) {
+            cerr << "Error: Model not trained. Call fit() first." << endl;
+            return;
+        }
+        LinearScorer::score(X, rows, coef.size(), coef.data(), intercept, out, numThreads);
+    }
+
+    vector<double> predictBatch(const vector<double>& X) const {
+        vector<double> out(coef.empty() ? 0 : X.size() / coef.size());
+        predictBatch(X.data(), out.size(), out.data());
+        return out;
+    }
+
     void evaluate() {
         if (!trained) {
             cerr << "Error: Model not trained yet." << endl;
             return;
         }
+        RegressionEvaluator::run(X.size(), numThreads, [&](size_t i, double& pred, double& actual) {
+            pred = intercept + slope * X[i];
+            actual = Y[i];
+            return true;
+        }).print();
+    }
+
+    // --- Metrics on any dataset with the training columns, scored in the same pass ---
+    RegressionMetrics evaluate(const Dataset& d, const vector<int>& xColumns, int yColumn, bool verbose = true) const {
+        if (!trained) {
+            cerr << "Error: Model not trained yet." << endl;
+            return {};
+        }
+        if (!validColumns(d.headers.size(), xColumns, yColumn)) return {};
+        if (xColumns.size() != coef.size()) {
+            cerr << "Error: Expected " << coef.size() << " feature columns, got " << xColumns.size() << "." << endl;
+            return {};
+        }
+        const ColumnStore& cs = d.columnar();
+        vector<NumericView> views;
+        for (int c : xColumns) views.push_back(cs.numeric(c));
+        NumericView yv = cs.numeric(yColumn);
 
-        double ssTot = 0.0, ssRes = 0.0;
-        double meanY = accumulate(Y.begin(), Y.end(), 0.0) / Y.size();
+        size_t dims = coef.size();
+        RegressionMetrics m = RegressionEvaluator::run(cs.nRows, numThreads, [&](size_t i, double& pred, double& actual) {
+            actual = yv[i];
+            pred = intercept;
+            for (size_t j = 0; j < dims; j++) pred += coef[j] * views[j][i];
+            return !std::isnan(pred) && !std::isnan(actual);
+        });
+        if (verbose) m.print();
+        return m;
+    }
 
-        for (int i = 0; i < Y.size(); i++) {
-            double yPred = predict(X[i]);
-            ssRes += pow(Y[i] - yPred, 2);
-            ssTot += pow(Y[i] - meanY, 2);
+    // --- k-fold cross-validation from per-fold sufficient statistics ---
+    // One pass gathers the moments of every fold. Each fold's model is solved from the
+    // merged moments of the others, and its test SSR follows exactly from the held-out
+    // fold's moments: sum (y - b0 - c.x)^2 = Cyy - 2 c.Cxy + c'Cxx c + n (ybar - b0 - c.xbar)^2.
+    // MAE and quantiles need the raw rows, so they are not reported per fold.
+    vector<RegressionMetrics> crossValidate(const Dataset& d, const vector<int>& xColumns, int yColumn,
+                                            int folds = 5, bool verbose = true) const {
+        if (!validColumns(d.headers.size(), xColumns, yColumn)) return {};
+        if (folds < 2) {
+            cerr << "Error: Cross-validation needs at least 2 folds." << endl;
+            return {};
         }
+        long long skipped = 0;
+        vector<RegressionMoments> parts = accumulateFolds(d, xColumns, yColumn, folds, skipped);
+        if (skipped)
+            cerr << "Warning: " << skipped << " rows with missing or non-numeric values skipped." << endl;
 
-        double r2 = 1 - (ssRes / ssTot);
+        size_t dims = xColumns.size();
+        vector<RegressionMetrics> results;
+        for (int f = 0; f < folds; f++) {
+            RegressionMoments train(dims);
+            for (int g = 0; g < folds; g++)
+                if (g != f) train.merge(parts[g]);
+            const RegressionMoments& test = parts[f];
+            RegressionMetrics m;
+            m.count = test.count;
+            if (train.count == 0 || test.count == 0) {
+                results.push_back(m);
+                continue;
+            }
 
-        cout << "\nModel Evaluation\n";
-        cout << "----------------\n";
-        cout << "Total Sum of Squares (SST) : " << ssTot << endl;
-        cout << "Residual Sum of Squares (SSR): " << ssRes << endl;
-        cout << "R^2 Score                  : " << r2 << endl;
+            vector<double> c;
+            double b0;
+            solveInto(train, c, b0);
+            double quad = test.at(dims, dims), offset = test.mean[dims] - b0;
+            for (size_t i = 0; i < dims; i++) {
+                quad -= 2 * c[i] * test.at(i, dims);
+                offset -= c[i] * test.mean[i];
+                for (size_t j = 0; j < dims; j++) quad += c[i] * test.at(i, j) * c[j];
+            }
+            m.sst = test.at(dims, dims);
+            m.ssr = max(0.0, quad) + test.count * offset * offset;
+            m.finish(NAN);
+            results.push_back(m);
+        }
+
+        if (verbose) {
+            cout << "\n" << folds << "-Fold Cross-Validation\n";
+            cout << "-----------------------\n";
+            cout << setw(6) << "Fold" << setw(10) << "Rows" << setw(14) << "MSE" << setw(14) << "RMSE" << setw(12) << "R^2" << endl;
+            ColumnStats mse, r2;
+            for (int f = 0; f < folds; f++) {
+                const RegressionMetrics& m = results[f];
+                cout << setw(6) << f + 1 << setw(10) << m.count << setw(14) << m.mse << setw(14) << m.rmse
+                     << setw(12) << m.r2 << endl;
+                if (m.count) {
+                    mse.add(m.mse);
+                    r2.add(m.r2);
+                }
+            }
+            cout << "Mean MSE: " << mse.mean << " (sd " << mse.stddev() << "), mean R^2: " << r2.mean
+                 << " (sd " << r2.stddev() << ")" << endl;
+        }
+        return results;
     }
 
     void printPredictions() {
@@ -112,7 +719,203 @@ public:
         cout << "-------------------\n";
         cout << setw(10) << "X" << setw(15) << "Actual Y" << setw(15) << "Predicted Y" << endl;
         for (int i = 0; i < X.size(); i++) {
-            cout << setw(10) << X[i] << setw(15) << Y[i] << setw(15) << predict(X[i]) << endl;
+            cout << setw(10) << X[i] << setw(15) << Y[i] << setw(15) << intercept + slope * X[i] << endl;
+        }
+    }
+};
+
+// --- Online linear regression trained by mini-batch SGD or Adam ---
+// partialFit() takes rows as they arrive. Features and target are standardised with
+// running statistics (Welford), so one learning rate works whatever the units; the
+// weights are mapped back to raw units when scoring.
+class OnlineRegression {
+public:
+    enum Optimizer { SGD, ADAM };
+
+private:
+    size_t d;
+    Optimizer optimizer;
+    vector<double> w;                // d weights, then the bias (standardised space)
+    vector<double> m, v;             // Adam moments, same layout as w
+    vector<ColumnStats> xStats;
+    ColumnStats yStats;
+    long long steps = 0;
+    double lastLoss = NAN;           // MSE of the last mini-batch, raw units
+
+    double learningRate;
+    size_t batchSize = 256;
+    double l2 = 0.0;
+    double beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+    int numThreads = 0;              // predictBatch; 0 = hardware concurrency
+
+    static double spread(const ColumnStats& st) {
+        double s = st.stddev();
+        return s > 0 ? s : 1.0;
+    }
+
+    // One optimiser step on rows [0, rows) of X / y (raw units)
+    void step(const double* X, const double* y, size_t rows) {
+        vector<double> grad(d + 1, 0.0), mu(d), sd(d);
+        for (size_t j = 0; j < d; j++) {
+            mu[j] = xStats[j].mean;
+            sd[j] = spread(xStats[j]);
+        }
+        double muY = yStats.mean, sdY = spread(yStats);
+
+        vector<double> z(d);
+        double loss = 0;
+        for (size_t i = 0; i < rows; i++) {
+            double pred = w[d];
+            for (size_t j = 0; j < d; j++) {
+                z[j] = (X[i * d + j] - mu[j]) / sd[j];
+                pred += w[j] * z[j];
+            }
+            double r = pred - (y[i] - muY) / sdY;
+            loss += r * r;
+            for (size_t j = 0; j < d; j++) grad[j] += r * z[j];
+            grad[d] += r;
+        }
+        for (size_t j = 0; j <= d; j++) grad[j] /= rows;
+        for (size_t j = 0; j < d; j++) grad[j] += l2 * w[j];
+        lastLoss = loss / rows * sdY * sdY;
+
+        steps++;
+        if (optimizer == SGD) {
+            for (size_t j = 0; j <= d; j++) w[j] -= learningRate * grad[j];
+            return;
+        }
+        double c1 = 1 - pow(beta1, (double)steps), c2 = 1 - pow(beta2, (double)steps);
+        for (size_t j = 0; j <= d; j++) {
+            m[j] = beta1 * m[j] + (1 - beta1) * grad[j];
+            v[j] = beta2 * v[j] + (1 - beta2) * grad[j] * grad[j];
+            w[j] -= learningRate * (m[j] / c1) / (sqrt(v[j] / c2) + epsilon);
+        }
+    }
+
+    // Add rows to the scaler. The weights are re-expressed under the new statistics so
+    // the raw-unit model is unchanged; only optimiser steps move it.
+    void updateScaler(const double* X, const double* y, size_t rows) {
+        bool first = yStats.count == 0;  // untrained weights already mean "predict the mean"
+        vector<double> c = coefficients();
+        double b = intercept();
+        for (size_t i = 0; i < rows; i++) {
+            for (size_t j = 0; j < d; j++) xStats[j].add(X[i * d + j]);
+            yStats.add(y[i]);
+        }
+        if (first) return;
+        double sdY = spread(yStats);
+        w[d] = b - yStats.mean;
+        for (size_t j = 0; j < d; j++) {
+            w[j] = c[j] * spread(xStats[j]) / sdY;
+            w[d] += c[j] * xStats[j].mean;
+        }
+        w[d] /= sdY;
+    }
+
+    void train(const double* X, const double* y, size_t rows) {
+        for (size_t b = 0; b < rows; b += batchSize)
+            step(X + b * d, y + b, min(batchSize, rows - b));
+    }
+
+    // Complete rows of a columnar batch as row-major X and y
+    bool collectRows(const Dataset& batch, const vector<int>& xColumns, int yColumn, vector<double>& X,
+                     vector<double>& y) const {
+        if (xColumns.size() != d) {
+            cerr << "Error: Expected " << d << " feature columns, got " << xColumns.size() << "." << endl;
+            return false;
+        }
+        const ColumnStore& cs = batch.columnar();
+        vector<NumericView> views;
+        for (int c : xColumns) views.push_back(cs.numeric(c));
+        NumericView yv = cs.numeric(yColumn);
+
+        X.clear();
+        y.clear();
+        X.reserve(cs.nRows * d);
+        y.reserve(cs.nRows);
+        for (size_t i = 0; i < cs.nRows; i++) {
+            bool ok = !std::isnan(yv[i]);
+            for (size_t j = 0; j < d && ok; j++) ok = !std::isnan(views[j][i]);
+            if (!ok) continue;
+            for (size_t j = 0; j < d; j++) X.push_back(views[j][i]);
+            y.push_back(yv[i]);
+        }
+        return true;
+    }
+
+public:
+    explicit OnlineRegression(size_t features, Optimizer opt = ADAM)
+        : d(features), optimizer(opt), w(features + 1, 0.0), m(features + 1, 0.0), v(features + 1, 0.0),
+          xStats(features), learningRate(opt == ADAM ? 0.01 : 0.05) {}
+
+    void setLearningRate(double rate) { learningRate = rate; }
+    void setBatchSize(size_t rows) { batchSize = max<size_t>(1, rows); }
+    void setL2(double penalty) { l2 = max(0.0, penalty); }
+    void setAdamBetas(double b1, double b2) { beta1 = b1; beta2 = b2; }
+    void setThreads(int threads) { numThreads = threads; }
+
+    size_t features() const { return d; }
+    long long rowsSeen() const { return (long long)yStats.count; }
+    long long updates() const { return steps; }
+    double lastBatchLoss() const { return lastLoss; }
+
+    // --- Update with rows x d row-major features and their targets ---
+    // The scaler sees the whole chunk first, then it is consumed in mini-batches.
+    void partialFit(const double* X, const double* y, size_t rows) {
+        updateScaler(X, y, rows);
+        train(X, y, rows);
+    }
+
+    // Columnar batch; rows with a missing value are skipped
+    void partialFit(const Dataset& batch, const vector<int>& xColumns, int yColumn) {
+        vector<double> X, y;
+        if (!collectRows(batch, xColumns, yColumn, X, y)) return;
+        partialFit(X.data(), y.data(), y.size());
+    }
+
+    // --- Several passes over a stream, reporting the last mini-batch loss per epoch ---
+    // The scaler is fitted during the first epoch only, so every row is counted once.
+    void fit(DatasetStream& stream, const vector<int>& xColumns, int yColumn, int epochs = 1, bool verbose = true) {
+        Dataset batch;
+        vector<double> X, y;
+        for (int e = 0; e < epochs; e++) {
+            stream.reset();
+            while (stream.next(batch)) {
+                if (e == 0) {
+                    partialFit(batch, xColumns, yColumn);
+                } else if (collectRows(batch, xColumns, yColumn, X, y)) {
+                    train(X.data(), y.data(), y.size());
+                }
+            }
+            if (verbose)
+                cout << "Epoch " << e + 1 << ": rows " << stream.rowsRead() << ", batch MSE " << lastLoss << endl;
         }
     }
+
+    // Weights and bias in raw units
+    vector<double> coefficients() const {
+        vector<double> c(d);
+        double sdY = spread(yStats);
+        for (size_t j = 0; j < d; j++) c[j] = w[j] * sdY / spread(xStats[j]);
+        return c;
+    }
+
+    double intercept() const {
+        vector<double> c = coefficients();
+        double b = yStats.mean + w[d] * spread(yStats);
+        for (size_t j = 0; j < d; j++) b -= c[j] * xStats[j].mean;
+        return b;
+    }
+
+    // --- Score rows x d row-major features into out[0..rows) ---
+    void predictBatch(const double* X, size_t rows, double* out) const {
+        vector<double> c = coefficients();
+        LinearScorer::score(X, rows, d, c.data(), intercept(), out, numThreads);
+    }
+
+    vector<double> predictBatch(const vector<double>& X) const {
+        vector<double> out(d ? X.size() / d : 0);
+        predictBatch(X.data(), out.size(), out.data());
+        return out;
+    }
 };
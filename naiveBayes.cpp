@@ -1,21 +1,373 @@
 #include <bits/stdc++.h>
 using namespace std;
 
+// --- Dictionary-encoded Naive Bayes counts ---
+// Classes and the values of each feature get dense integer ids as they are first seen;
+// the counts of a feature live in one flat [value][class] array.
+struct NaiveBayesCounts {
+    string classHeader;                           // name of the class column
+    vector<string> featureNames;
+    vector<int> featureCols;                      // record position of each feature
+    vector<string> classNames;                    // by class id
+    unordered_map<string, int> classIds;
+    vector<long long> classCounts;
+    vector<vector<string>> values;                // per feature, by value id
+    vector<unordered_map<string, int>> valueIds;
+    vector<vector<long long>> counts;             // per feature: valueId * numClasses() + classId
+    long long totalRows = 0;
+
+    int numClasses() const { return (int)classNames.size(); }
+
+    // Every column except the class column is a feature
+    void setFeatures(const vector<string>& headers, int classCol) {
+        *this = NaiveBayesCounts();
+        if (classCol >= 0 && classCol < (int)headers.size()) classHeader = headers[classCol];
+        for (int col = 0; col < (int)headers.size(); col++) {
+            if (col == classCol) continue;
+            featureNames.push_back(headers[col]);
+            featureCols.push_back(col);
+        }
+        values.resize(featureCols.size());
+        valueIds.resize(featureCols.size());
+        counts.resize(featureCols.size());
+    }
+
+    int classId(const string& name) {
+        auto it = classIds.find(name);
+        if (it != classIds.end()) return it->second;
+
+        // A new class widens every [value][class] table
+        int C = numClasses();
+        for (auto& table : counts) {
+            vector<long long> wider(table.size() / max(C, 1) * (C + 1), 0);
+            for (size_t v = 0; C && v < table.size() / C; v++)
+                copy(table.begin() + v * C, table.begin() + (v + 1) * C, wider.begin() + v * (C + 1));
+            table.swap(wider);
+        }
+        classIds.emplace(name, C);
+        classNames.push_back(name);
+        classCounts.push_back(0);
+        return C;
+    }
+
+    int valueId(size_t f, const string& value) {
+        auto it = valueIds[f].find(value);
+        if (it != valueIds[f].end()) return it->second;
+        int id = (int)values[f].size();
+        valueIds[f].emplace(value, id);
+        values[f].push_back(value);
+        counts[f].resize(counts[f].size() + numClasses(), 0);
+        return id;
+    }
+
+    // Count for (feature, value, class) without inserting anything
+    long long count(size_t f, const string& value, int cls) const {
+        auto it = valueIds[f].find(value);
+        return it == valueIds[f].end() ? 0 : counts[f][(size_t)it->second * numClasses() + cls];
+    }
+
+    // --- Add counts gathered over other rows (same features); ids are remapped by name ---
+    bool merge(const NaiveBayesCounts& o) {
+        if (o.featureNames != featureNames || o.featureCols != featureCols) {
+            cerr << "Error: Cannot merge Naive Bayes counts over different features." << endl;
+            return false;
+        }
+        vector<int> cls(o.numClasses());
+        for (int c = 0; c < o.numClasses(); c++) {
+            cls[c] = classId(o.classNames[c]);
+            classCounts[cls[c]] += o.classCounts[c];
+        }
+        for (size_t f = 0; f < featureCols.size(); f++)
+            for (size_t v = 0; v < o.values[f].size(); v++) {
+                size_t row = (size_t)valueId(f, o.values[f][v]) * numClasses();
+                for (int c = 0; c < o.numClasses(); c++) counts[f][row + cls[c]] += o.counts[f][v * o.numClasses() + c];
+            }
+        totalRows += o.totalRows;
+        return true;
+    }
+
+    // --- Binary form: class header, names, class counts, then each feature's values and count table ---
+    void write(ostream& out) const {
+        auto u32 = [&](uint32_t x) { out.write((const char*)&x, sizeof(x)); };
+        auto str = [&](const string& t) {
+            u32((uint32_t)t.size());
+            out.write(t.data(), t.size());
+        };
+        str(classHeader);
+        for (size_t f = 0; f < featureNames.size(); f++) {
+            str(featureNames[f]);
+            u32((uint32_t)featureCols[f]);
+        }
+        for (int c = 0; c < numClasses(); c++) str(classNames[c]);
+        out.write((const char*)classCounts.data(), classCounts.size() * sizeof(long long));
+        for (size_t f = 0; f < featureNames.size(); f++) {
+            u32((uint32_t)values[f].size());
+            for (auto& v : values[f]) str(v);
+            out.write((const char*)counts[f].data(), counts[f].size() * sizeof(long long));
+        }
+    }
+
+    // Counts come from an untrusted file: every table is sized only after checking that
+    // the bytes it needs are still left in the stream, and names and counts must be ones
+    // save() could have written (distinct names, class counts summing to rows).
+    bool read(istream& in, uint32_t features, uint32_t classes, uint64_t rows) {
+        *this = NaiveBayesCounts();
+        auto start = in.tellg();
+        in.seekg(0, ios::end);
+        uint64_t left = (uint64_t)(in.tellg() - start);
+        in.seekg(start);
+        auto take = [&](uint64_t bytes) {
+            if (bytes > left) return false;
+            left -= bytes;
+            return true;
+        };
+        auto u32 = [&](uint32_t& x) { return take(sizeof(x)) && in.read((char*)&x, sizeof(x)); };
+        auto str = [&](string& t) {
+            uint32_t len;
+            if (!u32(len) || !take(len)) return false;
+            t.resize(len);
+            return (bool)in.read(&t[0], len);
+        };
+        if (classes == 0 || rows == 0 || rows > (uint64_t)LLONG_MAX) return false;
+        if ((uint64_t)features * 2 * sizeof(uint32_t) > left || (uint64_t)classes * (sizeof(uint32_t) + sizeof(long long)) > left)
+            return false;
+        if (!str(classHeader)) return false;
+
+        featureNames.resize(features);
+        featureCols.resize(features);
+        for (uint32_t f = 0; f < features; f++) {
+            uint32_t col;
+            if (!str(featureNames[f]) || !u32(col)) return false;
+            featureCols[f] = (int)col;
+        }
+        for (uint32_t c = 0; c < classes; c++) {
+            string name;
+            if (!str(name) || !classIds.emplace(name, (int)c).second) return false;
+            classNames.push_back(name);
+        }
+        classCounts.resize(classes);
+        if (!take(classes * sizeof(long long)) || !in.read((char*)classCounts.data(), classes * sizeof(long long))) return false;
+        uint64_t sum = 0;
+        for (long long n : classCounts) {
+            if (n < 0 || (uint64_t)n > rows - sum) return false;
+            sum += n;
+        }
+        if (sum != rows) return false;
+
+        values.resize(features);
+        valueIds.resize(features);
+        counts.resize(features);
+        for (uint32_t f = 0; f < features; f++) {
+            uint32_t nValues;
+            if (!u32(nValues) || (uint64_t)nValues * sizeof(uint32_t) > left) return false;
+            values[f].resize(nValues);
+            for (uint32_t v = 0; v < nValues; v++) {
+                if (!str(values[f][v]) || !valueIds[f].emplace(values[f][v], (int)v).second) return false;
+            }
+            if (!take((uint64_t)nValues * classes * sizeof(long long))) return false;
+            counts[f].resize((size_t)nValues * classes);
+            if (!in.read((char*)counts[f].data(), counts[f].size() * sizeof(long long))) return false;
+            for (size_t i = 0; i < counts[f].size(); i++)
+                if (counts[f][i] < 0 || counts[f][i] > classCounts[i % classes]) return false;
+        }
+        totalRows = (long long)rows;
+        return true;
+    }
+
+    void addRow(const vector<string>& row, int classCol) {
+        if ((int)row.size() <= classCol) return;
+        int c = classId(row[classCol]);
+        classCounts[c]++;
+        totalRows++;
+        for (size_t f = 0; f < featureCols.size(); f++) {
+            if (featureCols[f] >= (int)row.size()) continue;
+            int v = valueId(f, row[featureCols[f]]);
+            counts[f][(size_t)v * numClasses() + c]++;
+        }
+    }
+};
+
+// --- Compiled model: Laplace-smoothed log-probability tables ---
+// Built from the counts after training. Class ids here are in name order (so ties go to
+// the same class as the old map-based code), and looking a value up never inserts it.
+struct CompiledNaiveBayes {
+    int numClasses = 0;
+    vector<string> classNames;                    // sorted
+    unordered_map<string, int> classIndex;        // name -> id
+    vector<int> featureCols;
+    vector<unordered_map<string, int>> valueIds;  // same ids as the counts
+    vector<size_t> slotBase;                      // first logLik row of each feature
+    vector<double> logPrior;                      // [class]
+    vector<double> logLik;                        // [slotBase[f] + value][class]
+    vector<double> logUnseen;                     // [feature][class], value not seen in training
+
+    static constexpr int STACK_CLASSES = 64;      // score buffer kept on the stack up to this
+
+    void build(const NaiveBayesCounts& nc) {
+        numClasses = nc.numClasses();
+        featureCols = nc.featureCols;
+        valueIds = nc.valueIds;
+
+        // Counts' class ids are in first-seen order; map them to name order
+        vector<int> byName(numClasses);
+        iota(byName.begin(), byName.end(), 0);
+        sort(byName.begin(), byName.end(), [&](int a, int b) { return nc.classNames[a] < nc.classNames[b]; });
+        classNames.clear();
+        classIndex.clear();
+        for (int c : byName) {
+            classIndex.emplace(nc.classNames[c], (int)classNames.size());
+            classNames.push_back(nc.classNames[c]);
+        }
+
+        logPrior.resize(numClasses);
+        for (int k = 0; k < numClasses; k++)
+            logPrior[k] = log((double)nc.classCounts[byName[k]] / nc.totalRows);
+
+        size_t F = featureCols.size();
+        slotBase.assign(F, 0);
+        size_t slots = 0;
+        for (size_t f = 0; f < F; f++) {
+            slotBase[f] = slots;
+            slots += nc.values[f].size();
+        }
+        logLik.assign(slots * numClasses, 0.0);
+        logUnseen.assign(F * numClasses, 0.0);
+        for (size_t f = 0; f < F; f++) {
+            double V = (double)nc.values[f].size();
+            for (int k = 0; k < numClasses; k++) {
+                int c = byName[k];
+                double logDenom = log(nc.classCounts[c] + V);
+                logUnseen[f * numClasses + k] = -logDenom;
+                for (size_t v = 0; v < nc.values[f].size(); v++)
+                    logLik[(slotBase[f] + v) * numClasses + k] = log(nc.counts[f][v * nc.numClasses() + c] + 1.0) - logDenom;
+            }
+        }
+    }
+
+    // log P(value | class) for every class; missing features (short records) give null
+    const double* row(size_t f, const vector<string>& record) const {
+        if (featureCols[f] >= (int)record.size()) return nullptr;
+        auto it = valueIds[f].find(record[featureCols[f]]);
+        if (it == valueIds[f].end()) return &logUnseen[f * numClasses];
+        return &logLik[(slotBase[f] + it->second) * numClasses];
+    }
+
+    // Log joint score of every class into scores[numClasses]; returns the best class id
+    int score(const vector<string>& record, double* scores) const {
+        copy(logPrior.begin(), logPrior.end(), scores);
+        for (size_t f = 0; f < featureCols.size(); f++) {
+            const double* r = row(f, record);
+            if (!r) continue;
+            for (int k = 0; k < numClasses; k++) scores[k] += r[k];
+        }
+        return (int)(max_element(scores, scores + numClasses) - scores);
+    }
+
+    // Posteriors from log scores via log-sum-exp (no underflow however many features)
+    void normalize(const double* scores, double* out) const {
+        double top = *max_element(scores, scores + numClasses), sum = 0;
+        for (int k = 0; k < numClasses; k++) sum += out[k] = exp(scores[k] - top);
+        for (int k = 0; k < numClasses; k++) out[k] /= sum;
+    }
+
+    int predictId(const vector<string>& record) const {
+        double stackScores[STACK_CLASSES];
+        if (numClasses <= STACK_CLASSES) return score(record, stackScores);
+        vector<double> scores(numClasses);
+        return score(record, scores.data());
+    }
+};
+
 class NaiveBayes {
+public:
+    // --- Output of predictBatch ---
+    struct BatchResult {
+        vector<int> predicted;        // class id per row, see classNames()
+        vector<double> posteriors;    // rows x classes, normalised (when requested)
+        vector<long long> confusion;  // classes x classes, [actual][predicted] (when requested)
+        long long labelled = 0;       // rows whose class column holds a known class
+        long long correct = 0;
+
+        double accuracy() const { return labelled ? (double)correct / labelled : 0.0; }
+    };
+
 private:
     Dataset data;
     int classCol;
-    set<string> classes;
-    map<string, int> classCounts;
-    map<string, map<string, map<string, int>>> featureCounts; // feature -> value -> class -> count
-    int totalRows = 0;
+    NaiveBayesCounts counts;
+    CompiledNaiveBayes model;
     bool trained = false;
+    int numThreads = 0;               // 0 = hardware concurrency
+    static constexpr size_t BLOCK = 4096; // rows per parallel work item
+
+    // Binary model file: header, then the count tables (NaiveBayesCounts::write)
+    struct ModelHeader {
+        char magic[8];
+        uint32_t version;
+        int32_t classCol;
+        uint32_t columns;    // columns of the training data (features + class column)
+        uint32_t features;
+        uint32_t classes;
+        uint32_t reserved = 0;
+        uint64_t totalRows;
+    };
+    static constexpr char MODEL_MAGIC[8] = {'D', 'M', '2', 'N', 'B', 'A', 'Y', '\0'};
+
+    // Add a block of rows to the class and feature-value counts
+    void countRows(const vector<vector<string>>& rows) {
+        for (auto& row : rows) counts.addRow(row, classCol);
+    }
+
+    void finishTraining(bool verbose) {
+        if (counts.totalRows == 0) {
+            cerr << "Error: Dataset is empty." << endl;
+            return;
+        }
+        model.build(counts);
+        trained = true;
+        if (verbose) printSummary();
+    }
+
+    // Ids of a dictionary in name order (the summary lists names alphabetically)
+    static vector<int> sortedIds(const vector<string>& names) {
+        vector<int> ids(names.size());
+        iota(ids.begin(), ids.end(), 0);
+        sort(ids.begin(), ids.end(), [&](int a, int b) { return names[a] < names[b]; });
+        return ids;
+    }
+
+    void printSummary() {
+        vector<int> classOrder = sortedIds(counts.classNames);
+        cout << "\nNaive Bayes Training Summary\n";
+        cout << "-----------------------------\n";
+        cout << "Total Records: " << counts.totalRows << endl;
+        cout << "\nClass Distribution:\n";
+        for (int c : classOrder)
+            cout << "  " << counts.classNames[c] << " : " << counts.classCounts[c] << endl;
+
+        cout << "\nFeature Counts by Class:\n";
+        for (int f : sortedIds(counts.featureNames)) {
+            cout << "\nFeature: " << counts.featureNames[f] << endl;
+            for (int v : sortedIds(counts.values[f])) {
+                cout << "  Value " << setw(10) << counts.values[f][v] << " -> ";
+                for (int c : classOrder) {
+                    long long n = counts.counts[f][(size_t)v * counts.numClasses() + c];
+                    if (n) cout << counts.classNames[c] << ":" << n << "  ";
+                }
+                cout << endl;
+            }
+        }
+    }
 
 public:
+    NaiveBayes(int classColumn) {
+        classCol = classColumn;
+    }
+
     NaiveBayes(Dataset d, int classColumn) {
         data = d;
+        data.materializeRows();
         classCol = classColumn;
-        totalRows = data.rows.size();
     }
 
     void fit(bool verbose = true) {
@@ -24,122 +376,225 @@ public:
             return;
         }
 
-        // Step 1: Count class frequencies
-        for (auto& row : data.rows) {
-            if (row.size() <= classCol) continue;
-            string cls = row[classCol];
-            classes.insert(cls);
-            classCounts[cls]++;
-        }
+        counts.setFeatures(data.headers, classCol);
+        countRows(data.rows);
+        finishTraining(verbose);
+    }
 
-        // Step 2: Count feature-value occurrences per class
-        for (int col = 0; col < data.headers.size(); col++) {
-            if (col == classCol) continue;
-            for (auto& row : data.rows) {
-                if (row.size() <= classCol) continue;
-                string feature = data.headers[col];
-                string value = row[col];
-                string cls = row[classCol];
-                featureCounts[feature][value][cls]++;
-            }
-        }
+    // --- Single pass over a stream; only the count tables are kept ---
+    void fit(DatasetStream& stream, bool verbose = true) {
+        data.headers = stream.headers;
+        counts.setFeatures(stream.headers, classCol);
+        Dataset batch;
 
-        trained = true;
+        stream.reset();
+        while (stream.next(batch)) countRows(batch.rows);
+        finishTraining(verbose);
+    }
 
-        if (verbose) {
-            cout << "\nNaive Bayes Training Summary\n";
-            cout << "-----------------------------\n";
-            cout << "Total Records: " << totalRows << endl;
-            cout << "\nClass Distribution:\n";
-            for (auto& c : classCounts)
-                cout << "  " << c.first << " : " << c.second << endl;
-
-            cout << "\nFeature Counts by Class:\n";
-            for (auto& f : featureCounts) {
-                cout << "\nFeature: " << f.first << endl;
-                for (auto& val : f.second) {
-                    cout << "  Value " << setw(10) << val.first << " -> ";
-                    for (auto& cls : val.second)
-                        cout << cls.first << ":" << cls.second << "  ";
-                    cout << endl;
-                }
-            }
+    // --- Add a batch of labelled rows to a trained (or empty) model ---
+    // The first batch fixes the feature columns; the tables are recompiled afterwards.
+    void partialFit(const Dataset& batch, bool verbose = false) {
+        if (counts.totalRows == 0) {
+            data.headers = batch.headers;
+            counts.setFeatures(batch.headers, classCol);
+        } else if (batch.headers != data.headers) {
+            cerr << "Error: Batch columns do not match the model." << endl;
+            return;
+        }
+        if (batch.rows.empty() && batch.size() > 0) {
+            Dataset rowsCopy = batch;
+            rowsCopy.materializeRows();
+            countRows(rowsCopy.rows);
+        } else {
+            countRows(batch.rows);
         }
+        finishTraining(verbose);
     }
 
-    string predict(vector<string> record, bool verbose = true) {
+    // --- Combine with a model trained on other rows (e.g. another shard); exact ---
+    bool merge(const NaiveBayes& other) {
+        if (other.classCol != classCol) {
+            cerr << "Error: Cannot merge models with different class columns." << endl;
+            return false;
+        }
+        if (counts.totalRows == 0) {
+            data.headers = other.data.headers;
+            counts = other.counts;
+        } else if (!counts.merge(other.counts)) {
+            return false;
+        }
+        finishTraining(false);
+        return true;
+    }
+
+    bool save(const string& filename) const {
         if (!trained) {
             cerr << "Error: Model not trained yet." << endl;
-            return "";
+            return false;
         }
+        ofstream out(filename, ios::binary);
+        if (!out.is_open()) {
+            cerr << "Error: Could not write " << filename << endl;
+            return false;
+        }
+        ModelHeader header;
+        memcpy(header.magic, MODEL_MAGIC, sizeof(header.magic));
+        header.version = 3;
+        header.classCol = classCol;
+        header.columns = (uint32_t)data.headers.size();
+        header.features = (uint32_t)counts.featureCols.size();
+        header.classes = (uint32_t)counts.numClasses();
+        header.totalRows = (uint64_t)counts.totalRows;
+        out.write((const char*)&header, sizeof(header));
+        counts.write(out);
+        return out.good();
+    }
 
-        map<string, double> posterior;
-
-        for (auto& cls : classes) {
-            // Start with prior probability P(C)
-            double prob = (double)classCounts[cls] / totalRows;
-
-            if (verbose)
-                cout << "\nCalculating P(" << cls << " | X):" << endl
-                     << "  Initial P(" << cls << ") = " << prob << endl;
+    // Replaces the model with one written by save(); ready to predict or keep training
+    bool load(const string& filename) {
+        ifstream in(filename, ios::binary);
+        ModelHeader header;
+        if (!in.is_open() || !in.read((char*)&header, sizeof(header)) ||
+            memcmp(header.magic, MODEL_MAGIC, sizeof(header.magic)) != 0 || header.version != 3) {
+            cerr << "Error: " << filename << " is not a DM2 Naive Bayes model." << endl;
+            return false;
+        }
+        NaiveBayesCounts loaded;
+        bool ok = header.classCol >= 0 && (uint32_t)header.classCol < header.columns &&
+                  header.features + 1 == header.columns && loaded.read(in, header.features, header.classes, header.totalRows);
+        // Feature positions must be distinct, in range and never the class column
+        for (uint32_t f = 0; ok && f < header.features; f++) {
+            int col = loaded.featureCols[f];
+            ok = col >= 0 && (uint32_t)col < header.columns && col != header.classCol &&
+                 (f == 0 || col > loaded.featureCols[f - 1]);
+        }
+        if (!ok) {
+            cerr << "Error: " << filename << " is truncated or corrupt." << endl;
+            return false;
+        }
 
-            // Multiply with conditional probabilities P(Xi | C)
-            for (int col = 0; col < data.headers.size(); col++) {
-                if (col == classCol) continue;
+        // Headers are rebuilt from the saved names, so partialFit() accepts the training columns
+        trained = false;
+        model = CompiledNaiveBayes();
+        classCol = header.classCol;
+        data = Dataset();
+        data.headers.assign(header.columns, "");
+        data.headers[classCol] = loaded.classHeader;
+        for (uint32_t f = 0; f < header.features; f++) data.headers[loaded.featureCols[f]] = loaded.featureNames[f];
+        counts = std::move(loaded);
+        finishTraining(false);
+        return trained;
+    }
 
-                string feature = data.headers[col];
-                string value = record[col];
-                int featureCount = featureCounts[feature][value][cls];
-                int totalForClass = classCounts[cls];
+    const CompiledNaiveBayes& compiled() const { return model; }
+    const vector<string>& classNames() const { return model.classNames; }
+    void setThreads(int threads) { numThreads = threads; }
 
-                // Apply Laplace smoothing
-                double condProb = (featureCount + 1.0) / (totalForClass + featureCounts[feature].size());
-                prob *= condProb;
+    string predict(const vector<string>& record, bool verbose = true) {
+        if (!trained) {
+            cerr << "Error: Model not trained yet." << endl;
+            return "";
+        }
+        if (!verbose) return model.classNames[model.predictId(record)];
 
-                if (verbose) {
-                    cout << "  P(" << feature << "=" << value << " | " << cls << ") = "
-                         << condProb << " (" << featureCount << "/" << totalForClass << ")\n";
-                }
+        vector<double> scores(model.numClasses), posterior(model.numClasses);
+        int best = model.score(record, scores.data());
+        model.normalize(scores.data(), posterior.data());
+        for (int k = 0; k < model.numClasses; k++) {
+            const string& cls = model.classNames[k];
+            int c = counts.classIds.at(cls);
+            cout << "\nCalculating P(" << cls << " | X):" << endl
+                 << "  Initial P(" << cls << ") = " << exp(model.logPrior[k]) << endl;
+            for (size_t f = 0; f < model.featureCols.size(); f++) {
+                const double* r = model.row(f, record);
+                if (!r) continue;
+                const string& value = record[model.featureCols[f]];
+                cout << "  P(" << counts.featureNames[f] << "=" << value << " | " << cls << ") = " << exp(r[k])
+                     << " (" << counts.count(f, value, c) << "/" << counts.classCounts[c] << ")\n";
             }
+            cout << "  ==> log P(" << cls << ", X) = " << scores[k] << endl;
+        }
+
+        cout << "\nFinal Posterior Probabilities:\n";
+        for (int k = 0; k < model.numClasses; k++)
+            cout << "  " << model.classNames[k] << " : " << posterior[k] << endl;
+        cout << "Predicted Class = " << model.classNames[best] << endl;
+        return model.classNames[best];
+    }
 
-            posterior[cls] = prob;
-            if (verbose)
-                cout << "  ==> Posterior(" << cls << ") = " << prob << endl;
+    // --- Score many records in parallel, in log space ---
+    // Rows are split into blocks handed to worker threads. Posteriors are normalised with
+    // log-sum-exp. With withConfusion, each row's class column is compared against the
+    // prediction in the same pass (per-thread matrices, merged at the end).
+    BatchResult predictBatch(const vector<vector<string>>& rows, bool withPosteriors = true,
+                             bool withConfusion = false) const {
+        BatchResult res;
+        if (!trained) {
+            cerr << "Error: Model not trained yet." << endl;
+            return res;
         }
+        int C = model.numClasses;
+        size_t n = rows.size();
+        res.predicted.resize(n);
+        if (withPosteriors) res.posteriors.resize(n * C);
 
-        // Choose class with maximum posterior probability
-        string bestClass;
-        double bestProb = -1;
-        for (auto& p : posterior) {
-            if (p.second > bestProb) {
-                bestProb = p.second;
-                bestClass = p.first;
+        int T = Parallel::resolveThreads(numThreads, max<size_t>(1, (n + BLOCK - 1) / BLOCK));
+        vector<vector<long long>> confusion(withConfusion ? T : 0, vector<long long>(C * C, 0));
+        Parallel::forBlocks(n, BLOCK, T, [&](size_t b, size_t e, int t) {
+            vector<double> scores(C);
+            for (size_t i = b; i < e; i++) {
+                int k = model.score(rows[i], scores.data());
+                res.predicted[i] = k;
+                if (withPosteriors) model.normalize(scores.data(), &res.posteriors[i * C]);
+                if (withConfusion && classCol < (int)rows[i].size()) {
+                    auto it = model.classIndex.find(rows[i][classCol]);
+                    if (it != model.classIndex.end()) confusion[t][it->second * C + k]++;
+                }
             }
-        }
+        });
 
-        if (verbose) {
-            cout << "\nFinal Posterior Probabilities:\n";
-            for (auto& p : posterior)
-                cout << "  " << p.first << " : " << p.second << endl;
-            cout << "Predicted Class = " << bestClass << endl;
+        if (withConfusion) {
+            res.confusion.assign(C * C, 0);
+            for (auto& m : confusion)
+                for (int i = 0; i < C * C; i++) res.confusion[i] += m[i];
+            for (int a = 0; a < C; a++)
+                for (int p = 0; p < C; p++) {
+                    res.labelled += res.confusion[a * C + p];
+                    if (a == p) res.correct += res.confusion[a * C + p];
+                }
         }
+        return res;
+    }
 
-        return bestClass;
+    void printConfusion(const BatchResult& res) const {
+        if (res.confusion.empty()) return;
+        int C = model.numClasses;
+        size_t w = 10;
+        for (auto& name : model.classNames) w = max(w, name.size() + 2);
+        cout << "\nConfusion Matrix (rows = actual, columns = predicted)\n";
+        cout << setw(w) << "";
+        for (auto& name : model.classNames) cout << setw(w) << name;
+        cout << endl;
+        for (int a = 0; a < C; a++) {
+            cout << setw(w) << model.classNames[a];
+            for (int p = 0; p < C; p++) cout << setw(w) << res.confusion[a * C + p];
+            cout << endl;
+        }
     }
 
-    void testAccuracy() {
+    void testAccuracy(bool showConfusion = false) {
         if (!trained) {
             cerr << "Error: Model not trained yet." << endl;
             return;
         }
 
-        int correct = 0;
-        for (auto& row : data.rows) {
-            string actual = row[classCol];
-            string predicted = predict(row, false);
-            if (predicted == actual) correct++;
+        if (data.rows.empty()) {
+            cerr << "Error: No training rows kept (streamed, merged or loaded model); use predictBatch." << endl;
+            return;
         }
-
-        cout << "\nModel Accuracy = " << (correct * 100.0 / totalRows) << " %" << endl;
+        BatchResult res = predictBatch(data.rows, false, true);
+        cout << "\nModel Accuracy = " << res.accuracy() * 100.0 << " %" << endl;
+        if (showConfusion) printConfusion(res);
     }
 };
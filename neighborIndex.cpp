@@ -0,0 +1,341 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// --- Fixed-radius neighbour search on a flat row-major n x d matrix ---
+// GRID   : uniform grid, cell size = build radius (low dimensions)
+// KDTREE : median-split KD-tree (moderate dimensions)
+// BRUTE  : linear scan (high dimensions / tiny inputs)
+// Every path compares squared distances against r^2, so they return the same sets.
+// Rows containing NaN have no neighbours and are never returned, as with a plain scan.
+class NeighborIndex {
+public:
+    enum Kind { AUTO, BRUTE, GRID, KDTREE };
+
+    static const char* kindName(Kind k) {
+        return k == GRID ? "grid" : k == KDTREE ? "kd-tree" : k == BRUTE ? "brute force" : "auto";
+    }
+
+    // X is copied (reordered for locality); radius sizes the grid cells
+    void build(const double* X, size_t rows, size_t dims, double radius, Kind requested = AUTO) {
+        n = rows;
+        d = dims;
+        cellSize = radius;
+        kind = requested == AUTO ? choose() : requested;
+
+        ids.clear();
+        pos.assign(n, NONE);
+        for (size_t i = 0; i < n; i++) {
+            bool ok = true;
+            for (size_t j = 0; j < d && ok; j++) ok = !std::isnan(X[i * d + j]);
+            if (ok) ids.push_back((int)i);
+        }
+
+        // The grid handles up to 3 dimensions and ranges that fit 64-bit cell keys
+        if (kind == GRID && (d > 3 || !buildGrid(X))) kind = KDTREE;
+        if (kind == KDTREE) buildTree(X);
+
+        pts.resize(ids.size() * d);
+        for (size_t p = 0; p < ids.size(); p++) {
+            copy(X + (size_t)ids[p] * d, X + ((size_t)ids[p] + 1) * d, &pts[p * d]);
+            pos[ids[p]] = p;
+        }
+    }
+
+    Kind type() const { return kind; }
+    size_t size() const { return n; }
+    size_t dims() const { return d; }
+    const double* row(size_t i) const { return pos[i] == NONE ? nullptr : &pts[pos[i] * d]; }
+
+    // --- Append every row j with ||q - x_j|| <= r to out (unordered) ---
+    void radiusQuery(const double* q, double r, vector<int>& out) const {
+        double r2 = r * r;
+        if (kind == GRID) queryGrid(q, r, r2, out);
+        else if (kind == KDTREE) { if (!nodes.empty()) queryTree(0, q, r, r2, out); }
+        else scanRange(q, 0, ids.size(), r2, out);
+    }
+
+    // Same query centred on indexed row i
+    void query(size_t i, double r, vector<int>& out) const {
+        if (pos[i] != NONE) radiusQuery(&pts[pos[i] * d], r, out);
+    }
+
+    double dist2(const double* a, const double* b) const { return DistanceKernel::sqEuclidean(a, b, d); }
+
+private:
+    static constexpr size_t NONE = SIZE_MAX;
+    static constexpr size_t LEAF = 32;
+
+    Kind kind = BRUTE;
+    size_t n = 0, d = 0;
+    double cellSize = 0;
+    vector<double> pts;   // valid rows in index order
+    vector<int> ids;      // index order -> original row
+    vector<size_t> pos;   // original row -> index order (NONE for NaN rows)
+
+    // Grid
+    vector<double> lo;
+    vector<uint64_t> extent;
+    unordered_map<uint64_t, pair<size_t, size_t>> cells;
+
+    // KD-tree
+    struct Node {
+        size_t begin, end;
+        int left = -1, right = -1;
+        size_t dim = 0;
+        double split = 0;
+    };
+    vector<Node> nodes;
+
+    Kind choose() const {
+        if (n < 64 || !(cellSize > 0)) return BRUTE;
+        if (d <= 3) return GRID;
+        if (d <= 16) return KDTREE;
+        return BRUTE;
+    }
+
+    void scanRange(const double* q, size_t begin, size_t end, double r2, vector<int>& out) const {
+        for (size_t p = begin; p < end; p++)
+            if (dist2(q, &pts[p * d]) <= r2) out.push_back(ids[p]);
+    }
+
+    // --- Grid ---
+    int64_t coord(double v, size_t j) const { return (int64_t)floor((v - lo[j]) / cellSize); }
+
+    bool buildGrid(const double* X) {
+        if (!(cellSize > 0) || ids.empty()) return false;
+        lo.assign(d, INFINITY);
+        vector<double> hi(d, -INFINITY);
+        for (int i : ids)
+            for (size_t j = 0; j < d; j++) {
+                lo[j] = min(lo[j], X[(size_t)i * d + j]);
+                hi[j] = max(hi[j], X[(size_t)i * d + j]);
+            }
+
+        extent.assign(d, 1);
+        double total = 1;
+        for (size_t j = 0; j < d; j++) {
+            double cellsInDim = floor((hi[j] - lo[j]) / cellSize) + 1;
+            if (!std::isfinite(cellsInDim)) return false;
+            total *= cellsInDim;
+            if (total > 1e18) return false;
+            extent[j] = (uint64_t)cellsInDim;
+        }
+
+        vector<pair<uint64_t, int>> keyed(ids.size());
+        for (size_t p = 0; p < ids.size(); p++) {
+            const double* x = X + (size_t)ids[p] * d;
+            uint64_t key = 0;
+            for (size_t j = 0; j < d; j++) key = key * extent[j] + (uint64_t)coord(x[j], j);
+            keyed[p] = {key, ids[p]};
+        }
+        sort(keyed.begin(), keyed.end());
+
+        cells.clear();
+        for (size_t p = 0; p < keyed.size(); p++) {
+            ids[p] = keyed[p].second;
+            if (p == 0 || keyed[p].first != keyed[p - 1].first) cells[keyed[p].first] = {p, p};
+            cells[keyed[p].first].second = p + 1;
+        }
+        return true;
+    }
+
+    void queryGrid(const double* q, double r, double r2, vector<int>& out) const {
+        if (cells.empty()) return;
+        // Cell bounds from q -/+ r: rounding is monotone, so no neighbour's cell is missed
+        int64_t first[3], last[3], cur[3];
+        for (size_t j = 0; j < d; j++) {
+            if (std::isnan(q[j])) return;
+            first[j] = max<int64_t>(0, coord(q[j] - r, j));
+            last[j] = min<int64_t>((int64_t)extent[j] - 1, coord(q[j] + r, j));
+            if (first[j] > last[j]) return;
+            cur[j] = first[j];
+        }
+
+        while (true) {
+            uint64_t key = 0;
+            for (size_t j = 0; j < d; j++) key = key * extent[j] + (uint64_t)cur[j];
+            auto it = cells.find(key);
+            if (it != cells.end()) scanRange(q, it->second.first, it->second.second, r2, out);
+
+            size_t j = d;
+            while (j > 0 && cur[j - 1] == last[j - 1]) {
+                cur[j - 1] = first[j - 1];
+                j--;
+            }
+            if (j == 0) break;
+            cur[j - 1]++;
+        }
+    }
+
+    // --- KD-tree (split on the widest dimension at the median) ---
+    void buildTree(const double* X) {
+        nodes.clear();
+        if (ids.empty()) return;
+        nodes.push_back({0, ids.size()});
+        vector<int> stack = {0};
+        while (!stack.empty()) {
+            int idx = stack.back();
+            stack.pop_back();
+            size_t b = nodes[idx].begin, e = nodes[idx].end;
+            if (e - b <= LEAF) continue;
+
+            size_t dim = 0;
+            double widest = -1;
+            for (size_t j = 0; j < d; j++) {
+                double mn = INFINITY, mx = -INFINITY;
+                for (size_t p = b; p < e; p++) {
+                    double v = X[(size_t)ids[p] * d + j];
+                    mn = min(mn, v);
+                    mx = max(mx, v);
+                }
+                if (mx - mn > widest) {
+                    widest = mx - mn;
+                    dim = j;
+                }
+            }
+            if (widest <= 0) continue;  // all points identical: keep as a leaf
+
+            size_t mid = b + (e - b) / 2;
+            nth_element(ids.begin() + b, ids.begin() + mid, ids.begin() + e, [&](int a, int c) {
+                return X[(size_t)a * d + dim] < X[(size_t)c * d + dim];
+            });
+            nodes[idx].dim = dim;
+            nodes[idx].split = X[(size_t)ids[mid] * d + dim];
+            nodes[idx].left = (int)nodes.size();
+            nodes.push_back({b, mid});
+            nodes[idx].right = (int)nodes.size();
+            nodes.push_back({mid, e});
+            stack.push_back(nodes[idx].left);
+            stack.push_back(nodes[idx].right);
+        }
+    }
+
+    // Left holds values <= split, right values >= split
+    void queryTree(int idx, const double* q, double r, double r2, vector<int>& out) const {
+        const Node& node = nodes[idx];
+        if (node.left < 0) {
+            scanRange(q, node.begin, node.end, r2, out);
+            return;
+        }
+        double v = q[node.dim];
+        if (v - r <= node.split) queryTree(node.left, q, r, r2, out);
+        if (v + r >= node.split) queryTree(node.right, q, r, r2, out);
+    }
+};
+
+// --- Every neighbour within maxEps, built once, sorted by distance per row (CSR) ---
+// A query for any eps <= maxEps is a prefix of a row, so DBSCAN eps / minPts sweeps
+// and k-distance plots reuse one build instead of repeating the radius searches.
+// Distances are kept squared and compared against eps^2, same as NeighborIndex.
+class NeighborGraph {
+public:
+    NeighborGraph() {}
+
+    NeighborGraph(const Dataset& data, double maxEps, int numThreads = 0, bool verbose = true) {
+        build(data, maxEps, numThreads, verbose);
+    }
+
+    void build(const Dataset& data, double maxEps, int numThreads = 0, bool verbose = true) {
+        size_t missing = 0;
+        vector<double> X = data.columnar().numericMatrix(&missing);
+        if (missing && verbose) cerr << "Warning: " << missing << " missing cells filled with column means." << endl;
+        build(X.data(), data.size(), data.headers.size(), maxEps, numThreads, verbose);
+    }
+
+    void build(const double* X, size_t n, size_t d, double maxEps, int numThreads = 0, bool verbose = true) {
+        auto t0 = chrono::steady_clock::now();
+        radius = maxEps;
+        idx.build(X, n, d, maxEps);
+
+        // Each block sorts its rows' neighbours into a private buffer, then the
+        // buffers are laid out back to back once the degrees are known
+        const size_t BLOCK = 1024;
+        size_t nBlocks = (n + BLOCK - 1) / BLOCK;
+        vector<vector<pair<double, int>>> blockEdges(nBlocks);
+        vector<size_t> degree(n, 0);
+        Parallel::forBlocks(n, BLOCK, numThreads, [&](size_t b, size_t e, int) {
+            vector<int> nb;
+            vector<pair<double, int>>& out = blockEdges[b / BLOCK];
+            for (size_t i = b; i < e; i++) {
+                nb.clear();
+                idx.query(i, maxEps, nb);
+                size_t start = out.size();
+                for (int j : nb) out.push_back({idx.dist2(idx.row(i), idx.row(j)), j});
+                sort(out.begin() + start, out.end());
+                degree[i] = nb.size();
+            }
+        });
+
+        offsets.assign(n + 1, 0);
+        for (size_t i = 0; i < n; i++) offsets[i + 1] = offsets[i] + degree[i];
+        adj.resize(offsets[n]);
+        dist2.resize(offsets[n]);
+        Parallel::forBlocks(nBlocks, 1, numThreads, [&](size_t b, size_t, int) {
+            size_t at = offsets[b * BLOCK];
+            for (auto& edge : blockEdges[b]) {
+                dist2[at] = edge.first;
+                adj[at++] = edge.second;
+            }
+            vector<pair<double, int>>().swap(blockEdges[b]);
+        });
+
+        if (verbose) {
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            double mb = (adj.size() * (sizeof(int) + sizeof(double)) + offsets.size() * sizeof(size_t)) / 1048576.0;
+            cout << "Neighbor graph: " << n << " rows, " << adj.size() << " edges within eps " << maxEps
+                 << " (" << mb << " MB, " << ms << " ms, " << NeighborIndex::kindName(idx.type()) << ")\n";
+        }
+    }
+
+    size_t size() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t edges() const { return adj.size(); }
+    double maxRadius() const { return radius; }
+    const NeighborIndex& index() const { return idx; }
+
+    // Rows within eps of row i, i itself included
+    size_t degree(size_t i, double eps) const {
+        const double* b = dist2.data() + offsets[i];
+        return upper_bound(b, b + (offsets[i + 1] - offsets[i]), eps * eps) - b;
+    }
+
+    // Append the rows within eps of row i, nearest first
+    void neighbors(size_t i, double eps, vector<int>& out) const {
+        const int* b = adj.data() + offsets[i];
+        out.insert(out.end(), b, b + degree(i, eps));
+    }
+
+    // --- Distance from every row to its k-th nearest other row (INFINITY beyond maxEps) ---
+    // A row is a DBSCAN core point for (eps, minPts) exactly when kDistances(minPts - 1) <= eps.
+    vector<double> kDistances(int k) const {
+        vector<double> out(size(), INFINITY);
+        for (size_t i = 0; i < size(); i++)
+            if (offsets[i] + k < offsets[i + 1]) out[i] = sqrt(dist2[offsets[i] + k]);
+        return out;
+    }
+
+    // Sorted descending: the curve whose knee is the usual choice of eps
+    vector<double> kDistancePlot(int k) const {
+        vector<double> out = kDistances(k);
+        sort(out.rbegin(), out.rend());
+        return out;
+    }
+
+    void printKDistance(int k, int samples = 20) const {
+        vector<double> plot = kDistancePlot(k);
+        cout << "\n" << k << "-distance plot (" << plot.size() << " rows, sorted descending)\n";
+        cout << "-------------------------------\n";
+        for (int s = 0; s < samples && !plot.empty(); s++) {
+            size_t r = (plot.size() - 1) * s / max(1, samples - 1);
+            cout << "  rank " << setw(8) << r << "  ";
+            if (std::isinf(plot[r])) cout << "> " << radius << "\n";
+            else cout << plot[r] << "\n";
+        }
+    }
+
+private:
+    double radius = 0;
+    NeighborIndex idx;
+    vector<size_t> offsets;  // n + 1
+    vector<int> adj;         // neighbour ids, nearest first within each row
+    vector<double> dist2;    // matching squared distances
+};
@@ -0,0 +1,163 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+class Parallel {
+public:
+    // --- Number of worker threads to use when the caller passes 0 ---
+    static int defaultThreads() {
+        unsigned n = thread::hardware_concurrency();
+        return n ? (int)n : 1;
+    }
+
+    static int resolveThreads(int nThreads, size_t work) {
+        if (nThreads <= 0) nThreads = defaultThreads();
+        return (int)max<size_t>(1, min<size_t>(nThreads, work));
+    }
+
+    // --- Split [0, n) into contiguous ranges, run fn(begin, end, threadId) on each ---
+    template <class F>
+    static void forRange(size_t n, int nThreads, F fn) {
+        nThreads = resolveThreads(nThreads, n);
+        if (nThreads == 1) {
+            fn((size_t)0, n, 0);
+            return;
+        }
+
+        vector<thread> workers;
+        for (int t = 1; t < nThreads; t++) {
+            size_t b = n * t / nThreads, e = n * (t + 1) / nThreads;
+            workers.emplace_back([&fn, b, e, t]() { fn(b, e, t); });
+        }
+        fn((size_t)0, n / nThreads, 0);
+        for (auto& w : workers) w.join();
+    }
+
+    // --- Same as forRange, but hands out blocks dynamically (uneven work per item) ---
+    template <class F>
+    static void forBlocks(size_t n, size_t blockSize, int nThreads, F fn) {
+        size_t nBlocks = (n + blockSize - 1) / blockSize;
+        nThreads = resolveThreads(nThreads, nBlocks);
+        atomic<size_t> next(0);
+
+        auto worker = [&](int t) {
+            size_t b;
+            while ((b = next.fetch_add(1)) < nBlocks)
+                fn(b * blockSize, min(n, (b + 1) * blockSize), t);
+        };
+
+        vector<thread> workers;
+        for (int t = 1; t < nThreads; t++) workers.emplace_back(worker, t);
+        worker(0);
+        for (auto& w : workers) w.join();
+    }
+};
+
+// --- Persistent worker threads for iterative algorithms ---
+// run(fn) calls fn(threadId) on every worker (the caller acts as worker 0) and waits.
+// Nothing is allocated per call, so it can sit inside tight iteration loops.
+class WorkerPool {
+public:
+    explicit WorkerPool(int nThreads = 0) {
+        int total = nThreads <= 0 ? Parallel::defaultThreads() : nThreads;
+        for (int t = 1; t < total; t++)
+            workers.emplace_back(&WorkerPool::loop, this, t);
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    int size() const { return (int)workers.size() + 1; }
+
+    template <class F>
+    void run(F& fn) {
+        {
+            lock_guard<mutex> lock(m);
+            ctx = &fn;
+            call = [](void* c, int t) { (*(F*)c)(t); };
+            pending = (int)workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        fn(0);
+
+        unique_lock<mutex> lock(m);
+        done.wait(lock, [&] { return pending == 0; });
+    }
+
+private:
+    vector<thread> workers;
+    mutex m;
+    condition_variable wake, done;
+    void (*call)(void*, int) = nullptr;
+    void* ctx = nullptr;
+    size_t generation = 0;
+    int pending = 0;
+    bool stopping = false;
+
+    void loop(int t) {
+        size_t seen = 0;
+        while (true) {
+            void (*fn)(void*, int);
+            void* arg;
+            {
+                unique_lock<mutex> lock(m);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                fn = call;
+                arg = ctx;
+            }
+            fn(arg, t);
+            {
+                lock_guard<mutex> lock(m);
+                if (--pending == 0) done.notify_one();
+            }
+        }
+    }
+};
+
+// --- Lock-free union-find over [0, n) ---
+// unite() always links the larger root under the smaller one, so after all unions
+// find(x) is the smallest element of x's set. find() does path halving with CAS.
+class ConcurrentDisjointSet {
+public:
+    explicit ConcurrentDisjointSet(size_t n = 0) { reset(n); }
+
+    void reset(size_t n) {
+        parent = vector<atomic<int>>(n);
+        for (size_t i = 0; i < n; i++) parent[i].store((int)i, memory_order_relaxed);
+    }
+
+    int find(int x) {
+        while (true) {
+            int p = parent[x].load(memory_order_relaxed);
+            if (p == x) return x;
+            int gp = parent[p].load(memory_order_relaxed);
+            if (p != gp) parent[x].compare_exchange_weak(p, gp, memory_order_relaxed);
+            x = gp;
+        }
+    }
+
+    void unite(int a, int b) {
+        while (true) {
+            a = find(a);
+            b = find(b);
+            if (a == b) return;
+            if (a < b) swap(a, b);
+            int expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, memory_order_relaxed)) return;
+        }
+    }
+
+private:
+    vector<atomic<int>> parent;
+};
@@ -1,11 +1,273 @@
 #include <bits/stdc++.h>
 using namespace std;
 
+// --- Typed columnar storage ---
+enum ColumnType { COL_NUMERIC, COL_INTEGER, COL_CATEGORICAL };
+
+// Read-only view over a contiguous block of doubles (no ownership)
+struct NumericView {
+    const double* ptr = nullptr;
+    size_t n = 0;
+
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    double operator[](size_t i) const { return ptr[i]; }
+    const double* begin() const { return ptr; }
+    const double* end() const { return ptr + n; }
+};
+
+// Read-only external backing for a column (e.g. a block of a mapped snapshot file)
+struct ExternalColumn {
+    const void* data = nullptr;        // double / int64 / int32 array, depending on type
+    size_t rows = 0;
+    const char* dictBlob = nullptr;    // categorical: uint64 offsets[dictCount + 1], then chars
+    size_t dictCount = 0;
+    size_t dictBytes = 0;              // whole blob, offsets included
+    shared_ptr<void> owner;            // keeps the mapping alive while any copy exists
+};
+
+// Missing values: an empty cell, or a cell that does not parse as a number, reads as NaN
+// through numeric(). Consumers either skip NaN (regression, Gaussian NB, preprocessing)
+// or get it filled with the column mean by ColumnStore::numericMatrix() (clustering).
+struct Column {
+    ColumnType type = COL_NUMERIC;
+    vector<double> values;     // COL_NUMERIC (NaN = missing)
+    vector<int64_t> ints;      // COL_INTEGER
+    vector<int32_t> codes;     // COL_CATEGORICAL: index into dict
+    mutable vector<string> dict;
+    mutable vector<double> doubleCache; // lazily filled double mirror of ints / codes
+    ExternalColumn ext;        // when ext.data is set the vectors above stay empty
+    mutable bool extChecked = false;
+    mutable vector<int32_t> extCodes;   // repaired copy of mapped codes (only if some were bad)
+
+    size_t size() const {
+        if (ext.data) return ext.rows;
+        if (type == COL_NUMERIC) return values.size();
+        if (type == COL_INTEGER) return ints.size();
+        return codes.size();
+    }
+
+    const double* valueData() const { return ext.data ? (const double*)ext.data : values.data(); }
+    const int64_t* intData() const { return ext.data ? (const int64_t*)ext.data : ints.data(); }
+    const int32_t* codeData() const {
+        if (!ext.data) return codes.data();
+        checkExternal();
+        return extCodes.empty() ? (const int32_t*)ext.data : extCodes.data();
+    }
+
+    const vector<string>& dictionary() const {
+        if (ext.dictBlob) checkExternal();
+        return dict;
+    }
+
+    // --- Mapped categorical column, checked on first access rather than at load ---
+    // Decodes the dictionary (offsets checked against the blob) and scans the codes, so
+    // only columns that are actually read get paged in. A bad dictionary is dropped and
+    // out-of-range codes read as an empty cell. Not thread-safe on first call.
+    void checkExternal() const {
+        if (extChecked || !ext.data || type != COL_CATEGORICAL) return;
+        extChecked = true;
+        const uint64_t* offsets = (const uint64_t*)ext.dictBlob;
+        uint64_t chars = ext.dictBytes - (ext.dictCount + 1) * sizeof(uint64_t);
+        bool ok = offsets[0] == 0;
+        for (size_t i = 0; i < ext.dictCount && ok; i++) ok = offsets[i] <= offsets[i + 1] && offsets[i + 1] <= chars;
+        dict.clear();
+        if (ok) {
+            const char* text = ext.dictBlob + (ext.dictCount + 1) * sizeof(uint64_t);
+            for (size_t i = 0; i < ext.dictCount; i++) dict.emplace_back(text + offsets[i], offsets[i + 1] - offsets[i]);
+        } else {
+            cerr << "Error: Mapped column has a corrupt dictionary; its cells read as empty." << endl;
+        }
+
+        const int32_t* p = (const int32_t*)ext.data;
+        size_t bad = 0;
+        for (size_t i = 0; i < ext.rows; i++) bad += p[i] < 0 || (size_t)p[i] >= dict.size();
+        if (!bad) return;
+        cerr << "Error: " << bad << " category codes out of range in a mapped column; read as empty." << endl;
+        int32_t missing = dict.size();
+        dict.emplace_back();
+        extCodes.assign(p, p + ext.rows);
+        for (auto& c : extCodes)
+            if (c < 0 || c >= missing) c = missing;
+    }
+
+    // Numeric view of the column. Categorical columns are parsed cell by cell (once per
+    // dictionary entry), so in a mixed column only the non-numeric cells read as NaN.
+    // Not thread-safe on first call for integer/categorical columns (fills the cache).
+    NumericView numeric() const {
+        if (type == COL_NUMERIC) return {valueData(), size()};
+        if (doubleCache.size() != size()) {
+            doubleCache.assign(size(), 0.0);
+            if (type == COL_INTEGER) {
+                const int64_t* p = intData();
+                for (size_t i = 0; i < size(); i++) doubleCache[i] = (double)p[i];
+            } else {
+                const vector<string>& words = dictionary();
+                vector<double> parsed(words.size());
+                for (size_t k = 0; k < words.size(); k++) parsed[k] = parseNumber(words[k]);
+                const int32_t* p = codeData();
+                for (size_t i = 0; i < size(); i++) doubleCache[i] = parsed[p[i]];
+            }
+        }
+        return {doubleCache.data(), doubleCache.size()};
+    }
+
+    // Whole cell as a number; NaN when empty or not numeric
+    static double parseNumber(const string& s) {
+        if (s.empty()) return NAN;
+        char* end = nullptr;
+        double v = strtod(s.c_str(), &end);
+        return *end == 0 ? v : NAN;
+    }
+
+    // Shortest text that parses back to the same double; empty for NaN
+    static string formatNumber(double v) {
+        if (std::isnan(v)) return "";
+        char buf[32];
+        auto res = to_chars(buf, buf + sizeof(buf), v);
+        return string(buf, res.ptr);
+    }
+
+    // Cell as text (adapter for the row API)
+    string cell(size_t r) const {
+        if (type == COL_CATEGORICAL) return dictionary()[codeData()[r]];
+        if (type == COL_INTEGER) return to_string(intData()[r]);
+        return formatNumber(valueData()[r]);
+    }
+};
+
+class ColumnStore {
+public:
+    vector<Column> cols;
+    size_t nRows = 0;
+
+    // --- Infer per-column types from string cells ---
+    static ColumnType inferType(const vector<const string*>& cells) {
+        bool allInt = true, allNum = true, anyValue = false;
+        for (auto* c : cells) {
+            if (c->empty()) { allInt = false; continue; }
+            anyValue = true;
+            char* end = nullptr;
+            errno = 0;
+            strtoll(c->c_str(), &end, 10);
+            if (*end != 0 || errno == ERANGE) allInt = false;
+            strtod(c->c_str(), &end);
+            if (*end != 0) { allNum = false; break; }
+        }
+        if (!anyValue || !allNum) return COL_CATEGORICAL;
+        return allInt ? COL_INTEGER : COL_NUMERIC;
+    }
+
+    // --- Build from row-major strings ---
+    void build(const vector<vector<string>>& rows, size_t nCols) {
+        cols.assign(nCols, Column());
+        nRows = rows.size();
+        static const string empty;
+
+        for (size_t j = 0; j < nCols; j++) {
+            vector<const string*> cells(nRows);
+            for (size_t i = 0; i < nRows; i++)
+                cells[i] = j < rows[i].size() ? &rows[i][j] : &empty;
+
+            Column& col = cols[j];
+            col.type = inferType(cells);
+
+            if (col.type == COL_INTEGER) {
+                col.ints.resize(nRows);
+                for (size_t i = 0; i < nRows; i++)
+                    col.ints[i] = strtoll(cells[i]->c_str(), nullptr, 10);
+            } else if (col.type == COL_NUMERIC) {
+                col.values.resize(nRows);
+                for (size_t i = 0; i < nRows; i++)
+                    col.values[i] = cells[i]->empty() ? NAN : strtod(cells[i]->c_str(), nullptr);
+            } else {
+                unordered_map<string, int32_t> ids;
+                col.codes.resize(nRows);
+                for (size_t i = 0; i < nRows; i++) {
+                    auto it = ids.find(*cells[i]);
+                    if (it == ids.end()) {
+                        it = ids.emplace(*cells[i], (int32_t)col.dict.size()).first;
+                        col.dict.push_back(*cells[i]);
+                    }
+                    col.codes[i] = it->second;
+                }
+            }
+        }
+    }
+
+    size_t numCols() const { return cols.size(); }
+    NumericView numeric(int col) const { return cols[col].numeric(); }
+
+    // Row-major numeric copy (for algorithms that need contiguous points)
+    // Missing cells are filled with their column mean (0 when the column has no values);
+    // missing, when given, receives the number of cells filled.
+    vector<double> numericMatrix(size_t* missing = nullptr) const {
+        size_t d = cols.size(), filled = 0;
+        vector<double> out(nRows * d);
+        for (size_t j = 0; j < d; j++) {
+            NumericView v = cols[j].numeric();
+            double sum = 0;
+            size_t count = 0;
+            for (size_t i = 0; i < nRows; i++)
+                if (!std::isnan(v[i])) {
+                    sum += v[i];
+                    count++;
+                }
+            double mean = count ? sum / count : 0.0;
+            for (size_t i = 0; i < nRows; i++) out[i * d + j] = std::isnan(v[i]) ? mean : v[i];
+            filled += nRows - count;
+        }
+        if (missing) *missing = filled;
+        return out;
+    }
+};
+
 class Dataset {
 public:
     vector<string> headers;
     vector<vector<string>> rows;
 
+    // --- Columnar backend ---
+    // Built lazily from rows, or filled directly by a columnar loader
+    // (in which case rows stay empty until materializeRows() is called).
+    const ColumnStore& columnar() const {
+        if (!columnsValid) {
+            store.build(rows, headers.size());
+            columnsValid = true;
+        }
+        return store;
+    }
+
+    ColumnStore& mutableColumns() {
+        columnar();
+        return store;
+    }
+
+    void setColumns(ColumnStore cs) {
+        store = std::move(cs);
+        columnsValid = true;
+        rows.clear();
+    }
+
+    // Call after editing or replacing rows so the typed columns are rebuilt on
+    // next access (materializeRows() first if the data lives only in columns)
+    void invalidateColumns() {
+        columnsValid = false;
+        store = ColumnStore();
+    }
+
+    // Zero-copy numeric view of one column
+    NumericView numericColumn(int colIndex) const { return columnar().numeric(colIndex); }
+
+    // --- Row adapter: rebuild string rows from the typed columns ---
+    void materializeRows() {
+        if (!rows.empty() || !columnsValid) return;
+        rows.assign(store.nRows, vector<string>(store.numCols()));
+        for (size_t j = 0; j < store.numCols(); j++)
+            for (size_t i = 0; i < store.nRows; i++)
+                rows[i][j] = store.cols[j].cell(i);
+    }
+
     // --- Print dataset neatly ---
     void print(int maxRows = 10) const {
         if (headers.size()) {
@@ -16,6 +278,18 @@ public:
 
         cout << string(15 * headers.size(), '-') << endl;
 
+        if (rows.empty() && columnsValid) {
+            size_t shown = min((size_t)maxRows, store.nRows);
+            for (size_t i = 0; i < shown; i++) {
+                for (auto& col : store.cols)
+                    cout << setw(15) << col.cell(i);
+                cout << endl;
+            }
+            if (store.nRows > shown)
+                cout << "... (" << store.nRows - shown << " more rows)" << endl;
+            return;
+        }
+
         int count = 0;
         for (auto& row : rows) {
             for (auto& val : row)
@@ -38,6 +312,10 @@ public:
         }
         int idx = distance(headers.begin(), it);
         vector<string> col;
+        if (rows.empty() && columnsValid) {
+            for (size_t i = 0; i < store.nRows; i++) col.push_back(store.cols[idx].cell(i));
+            return col;
+        }
         for (auto& row : rows)
             if (idx < row.size()) col.push_back(row[idx]);
         return col;
@@ -51,7 +329,11 @@ public:
     }
 
     // --- Get number of rows ---
-    size_t size() const { return rows.size(); }
+    size_t size() const { return rows.empty() && columnsValid ? store.nRows : rows.size(); }
+
+private:
+    mutable ColumnStore store;
+    mutable bool columnsValid = false;
 };
 
 // Trim spaces
@@ -0,0 +1,227 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// --- Binary columnar snapshot (.dm2) ---
+//
+// Layout (little-endian, every block 64-byte aligned):
+//   SnapshotHeader
+//   SnapshotColumn[nCols]
+//   column names (nameLen bytes each, back to back)
+//   per column: data block (double / int64 / int32 codes)
+//               categorical only: dict block = uint64 offsets[dictCount + 1], then chars
+//
+// Loading maps the file and points each Column at its block, so nothing is parsed
+// and the OS only faults in the pages of the columns an algorithm actually reads.
+class Snapshot {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    static bool save(const Dataset& data, const string& filename) {
+        const ColumnStore& cs = data.columnar();
+        ofstream out(filename, ios::binary);
+        if (!out.is_open()) {
+            cerr << "Error: Could not write snapshot " << filename << endl;
+            return false;
+        }
+
+        size_t nCols = cs.numCols();
+        SnapshotHeader header;
+        memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.nCols = nCols;
+        header.nRows = cs.nRows;
+
+        vector<SnapshotColumn> desc(nCols);
+        uint64_t offset = sizeof(SnapshotHeader) + nCols * sizeof(SnapshotColumn);
+        for (size_t j = 0; j < nCols; j++) {
+            desc[j].nameLen = j < data.headers.size() ? data.headers[j].size() : 0;
+            offset += desc[j].nameLen;
+        }
+
+        for (size_t j = 0; j < nCols; j++) {
+            const Column& col = cs.cols[j];
+            desc[j].type = col.type;
+            offset = align(offset);
+            desc[j].dataOffset = offset;
+            desc[j].dataBytes = cs.nRows * (col.type == COL_CATEGORICAL ? sizeof(int32_t) : 8);
+            offset += desc[j].dataBytes;
+
+            if (col.type == COL_CATEGORICAL) {
+                const vector<string>& dict = col.dictionary();
+                uint64_t chars = 0;
+                for (auto& s : dict) chars += s.size();
+                offset = align(offset);
+                desc[j].dictOffset = offset;
+                desc[j].dictCount = dict.size();
+                desc[j].dictBytes = (dict.size() + 1) * sizeof(uint64_t) + chars;
+                offset += desc[j].dictBytes;
+            }
+        }
+
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)desc.data(), nCols * sizeof(SnapshotColumn));
+        for (size_t j = 0; j < nCols; j++)
+            if (desc[j].nameLen) out.write(data.headers[j].data(), desc[j].nameLen);
+
+        for (size_t j = 0; j < nCols; j++) {
+            const Column& col = cs.cols[j];
+            pad(out, desc[j].dataOffset);
+            if (col.type == COL_NUMERIC) out.write((const char*)col.valueData(), desc[j].dataBytes);
+            else if (col.type == COL_INTEGER) out.write((const char*)col.intData(), desc[j].dataBytes);
+            else out.write((const char*)col.codeData(), desc[j].dataBytes);
+
+            if (col.type == COL_CATEGORICAL) {
+                const vector<string>& dict = col.dictionary();
+                pad(out, desc[j].dictOffset);
+                vector<uint64_t> offsets(dict.size() + 1, 0);
+                for (size_t i = 0; i < dict.size(); i++) offsets[i + 1] = offsets[i] + dict[i].size();
+                out.write((const char*)offsets.data(), offsets.size() * sizeof(uint64_t));
+                for (auto& s : dict) out.write(s.data(), s.size());
+            }
+        }
+
+        return out.good();
+    }
+
+    // Map a snapshot; columns stay on disk until first touched
+    static Dataset load(const string& filename, bool verbose = true) {
+        Dataset data;
+        auto t0 = chrono::steady_clock::now();
+
+        auto file = make_shared<MappedFile>();
+        if (!file->open(filename, MADV_NORMAL) || file->size < sizeof(SnapshotHeader)) {
+            cerr << "Error: Could not open snapshot " << filename << endl;
+            return data;
+        }
+
+        const SnapshotHeader* header = (const SnapshotHeader*)file->data;
+        if (memcmp(header->magic, MAGIC, sizeof(header->magic)) != 0 || header->version != VERSION) {
+            cerr << "Error: " << filename << " is not a DM2 snapshot (version " << VERSION << ")" << endl;
+            return data;
+        }
+
+        // Every size and offset is checked against the file before any Column is built
+        uint64_t size = file->size, nCols = header->nCols, nRows = header->nRows;
+        auto corrupt = [&](const string& what) {
+            cerr << "Error: Snapshot " << filename << " is corrupt or truncated (" << what << ")." << endl;
+            return Dataset();
+        };
+        if (!fits(sizeof(SnapshotHeader), nCols * sizeof(SnapshotColumn), size)) return corrupt("column table");
+        const SnapshotColumn* desc = (const SnapshotColumn*)(file->data + sizeof(SnapshotHeader));
+        uint64_t namesOffset = sizeof(SnapshotHeader) + nCols * sizeof(SnapshotColumn), namesBytes = 0;
+        for (uint64_t j = 0; j < nCols; j++) namesBytes += desc[j].nameLen;  // < 2^32 * 2^32, no overflow
+        if (!fits(namesOffset, namesBytes, size)) return corrupt("column names");
+
+        for (uint64_t j = 0; j < nCols; j++) {
+            const SnapshotColumn& c = desc[j];
+            if (c.type > COL_CATEGORICAL) return corrupt("column type");
+            uint64_t width = c.type == COL_CATEGORICAL ? sizeof(int32_t) : 8;
+            if (nRows > size / width || c.dataBytes != nRows * width) return corrupt("data size");
+            if (c.dataOffset % width != 0 || !fits(c.dataOffset, c.dataBytes, size)) return corrupt("data block");
+            if (c.type != COL_CATEGORICAL) continue;
+
+            if (c.dictCount > (uint64_t)INT32_MAX || c.dictOffset % sizeof(uint64_t) != 0 ||
+                !fits(c.dictOffset, c.dictBytes, size) || c.dictBytes / sizeof(uint64_t) < c.dictCount + 1)
+                return corrupt("dictionary block");
+            // Dictionary offsets and codes are checked by Column on first access, so
+            // loading never pages in column data
+        }
+
+        const char* names = file->data + namesOffset;
+        ColumnStore cs;
+        cs.nRows = nRows;
+        cs.cols.resize(nCols);
+        for (uint64_t j = 0; j < nCols; j++) {
+            data.headers.emplace_back(names, desc[j].nameLen);
+            names += desc[j].nameLen;
+
+            Column& col = cs.cols[j];
+            col.type = (ColumnType)desc[j].type;
+            col.ext.data = file->data + desc[j].dataOffset;
+            col.ext.rows = nRows;
+            col.ext.owner = file;
+            if (col.type == COL_CATEGORICAL) {
+                col.ext.dictBlob = file->data + desc[j].dictOffset;
+                col.ext.dictCount = desc[j].dictCount;
+                col.ext.dictBytes = desc[j].dictBytes;
+            }
+        }
+        data.setColumns(std::move(cs));
+
+        if (verbose) {
+            double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            cout << "Mapped snapshot: " << data.size() << " rows, " << data.headers.size()
+                 << " columns (" << ms << " ms)\n";
+        }
+        return data;
+    }
+
+    // --- Reload time of readCSV vs. the snapshot on the same data ---
+    static void compareReload(const string& csvFile, const string& snapFile) {
+        auto t0 = chrono::steady_clock::now();
+        Dataset fromCSV = readCSV(csvFile);
+        fromCSV.columnar();
+        auto t1 = chrono::steady_clock::now();
+
+        if (!save(fromCSV, snapFile)) return;
+
+        auto t2 = chrono::steady_clock::now();
+        Dataset fromSnap = load(snapFile, false);
+        auto t3 = chrono::steady_clock::now();
+
+        // Touch every column once so the comparison includes faulting the data in
+        double checksum = 0;
+        const ColumnStore& cs = fromSnap.columnar();
+        for (size_t j = 0; j < cs.numCols(); j++)
+            for (double v : cs.numeric(j))
+                if (!std::isnan(v)) checksum += v;
+        auto t4 = chrono::steady_clock::now();
+
+        auto ms = [](auto a, auto b) { return chrono::duration<double, milli>(b - a).count(); };
+        cout << "\nReload comparison (" << fromCSV.size() << " rows)\n";
+        cout << "------------------------------\n";
+        cout << "readCSV + typing     : " << ms(t0, t1) << " ms\n";
+        cout << "Snapshot map         : " << ms(t2, t3) << " ms\n";
+        cout << "Snapshot map + touch : " << ms(t2, t4) << " ms  (checksum " << checksum << ")\n";
+    }
+
+private:
+    static constexpr char MAGIC[8] = {'D', 'M', '2', 'S', 'N', 'A', 'P', '\0'};
+    static constexpr uint64_t ALIGN = 64;
+
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t nCols;
+        uint64_t nRows;
+        uint64_t reserved[5] = {0, 0, 0, 0, 0};
+    };
+
+    struct SnapshotColumn {
+        uint32_t type = 0;
+        uint32_t nameLen = 0;
+        uint64_t dataOffset = 0, dataBytes = 0;
+        uint64_t dictOffset = 0, dictCount = 0, dictBytes = 0;
+        uint64_t reserved = 0;
+    };
+
+    // [offset, offset + bytes) lies inside a file of the given size (no overflow)
+    static bool fits(uint64_t offset, uint64_t bytes, uint64_t size) { return offset <= size && bytes <= size - offset; }
+
+    static uint64_t align(uint64_t offset) { return (offset + ALIGN - 1) / ALIGN * ALIGN; }
+
+    static void pad(ofstream& out, uint64_t target) {
+        static const char zeros[ALIGN] = {};
+        uint64_t pos = out.tellp();
+        if (target > pos) out.write(zeros, target - pos);
+    }
+};
+
+// --- Convenience wrappers matching readCSV ---
+bool saveSnapshot(const Dataset& data, const string& filename) {
+    return Snapshot::save(data, filename);
+}
+
+Dataset loadSnapshot(const string& filename) {
+    return Snapshot::load(filename);
+}
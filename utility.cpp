@@ -1,6 +1,37 @@
 #include <bits/stdc++.h>
 using namespace std;
 
+// --- Running statistics for one numeric column (Welford) ---
+struct ColumnStats {
+    size_t count = 0;
+    double minVal = INFINITY, maxVal = -INFINITY;
+    double mean = 0.0, m2 = 0.0;
+
+    void add(double x) {
+        count++;
+        minVal = min(minVal, x);
+        maxVal = max(maxVal, x);
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+
+    // Combine with stats gathered over a disjoint set of values (Chan et al.)
+    void merge(const ColumnStats& o) {
+        if (o.count == 0) return;
+        if (count == 0) { *this = o; return; }
+        size_t n = count + o.count;
+        double delta = o.mean - mean;
+        mean += delta * o.count / n;
+        m2 += o.m2 + delta * delta * ((double)count * o.count / n);
+        count = n;
+        minVal = min(minVal, o.minVal);
+        maxVal = max(maxVal, o.maxVal);
+    }
+
+    double stddev() const { return count ? sqrt(m2 / count) : 0.0; }
+};
+
 class Preprocessing {
 public:
     // --- HELPER FUNCTIONS ---
@@ -20,6 +51,14 @@ public:
         }
     }
 
+    // isNumeric + toDouble with a single parse
+    static bool parseNumeric(const string& s, double& out) {
+        if (s.empty()) return false;
+        char* endptr = 0;
+        out = strtod(s.c_str(), &endptr);
+        return (*endptr == 0);
+    }
+
     static string toString(double val) {
         ostringstream ss;
         ss << val;
@@ -28,6 +67,7 @@ public:
 
     // --- 1. MIN-MAX NORMALIZATION ---
     static void normalizeColumn(Dataset& data, int colIndex) {
+        data.materializeRows();
         vector<double> values;
         for (auto& row : data.rows)
             if (isNumeric(row[colIndex]))
@@ -51,10 +91,12 @@ public:
                 row[colIndex] = toString(norm);
             }
         }
+        data.invalidateColumns();
     }
 
     // --- 2. STANDARDIZATION (Z-SCORE) ---
     static void standardizeColumn(Dataset& data, int colIndex) {
+        data.materializeRows();
         vector<double> values;
         for (auto& row : data.rows)
             if (isNumeric(row[colIndex]))
@@ -77,10 +119,12 @@ public:
                 row[colIndex] = toString(z);
             }
         }
+        data.invalidateColumns();
     }
 
     // --- 3. CATEGORICAL → NUMERIC (Label Encoding) ---
     static void categoricalToNumeric(Dataset& data, int colIndex) {
+        data.materializeRows();
         map<string, int> mapping;
         int nextVal = 0;
 
@@ -96,10 +140,12 @@ public:
 
         for (auto& row : data.rows)
             row[colIndex] = toString(mapping[row[colIndex]]);
+        data.invalidateColumns();
     }
 
     // --- 4. NUMERIC → CATEGORICAL (Discretization) ---
     static void numericToCategorical(Dataset& data, int colIndex, int bins, const string& method = "equal-width") {
+        data.materializeRows();
         vector<double> values;
         for (auto& row : data.rows)
             if (isNumeric(row[colIndex]))
@@ -134,10 +180,12 @@ public:
                 row[colIndex] = "Bin" + toString(bin + 1);
             }
         }
+        data.invalidateColumns();
     }
 
     // --- 5. BINNING BY MEAN ---
     static void binningByMean(Dataset& data, int colIndex, int binSize) {
+        data.materializeRows();
         vector<double> values;
         for (auto& row : data.rows)
             if (isNumeric(row[colIndex]))
@@ -162,10 +210,12 @@ public:
 
         for (auto& row : data.rows)
             row[colIndex] = toString(values[idx++]);
+        data.invalidateColumns();
     }
 
     // --- 6. BINNING BY MEDIAN ---
     static void binningByMedian(Dataset& data, int colIndex, int binSize) {
+        data.materializeRows();
         vector<double> values;
         for (auto& row : data.rows)
             if (isNumeric(row[colIndex]))
@@ -190,10 +240,12 @@ public:
 
         for (auto& row : data.rows)
             row[colIndex] = toString(values[idx++]);
+        data.invalidateColumns();
     }
 
     // --- 7. CORRELATION BETWEEN TWO NUMERIC COLUMNS ---
     static double correlation(Dataset& data, int colA, int colB) {
+        data.materializeRows();
         vector<double> A, B;
         for (auto& row : data.rows) {
             if (isNumeric(row[colA]) && isNumeric(row[colB])) {
@@ -219,4 +271,258 @@ public:
              << ") = " << corr << endl;
         return corr;
     }
+    // --- 8. SINGLE-PASS STATISTICS OVER A STREAM ---
+    // One pass gathers min/max/mean/std for every requested column.
+    static vector<ColumnStats> columnStats(DatasetStream& stream, const vector<int>& cols) {
+        vector<ColumnStats> stats(cols.size());
+        Dataset batch;
+        double x;
+
+        stream.reset();
+        while (stream.next(batch)) {
+            for (auto& row : batch.rows)
+                for (size_t k = 0; k < cols.size(); k++)
+                    if ((size_t)cols[k] < row.size() && parseNumeric(row[cols[k]], x))
+                        stats[k].add(x);
+        }
+        return stats;
+    }
+
+    // Apply precomputed stats to one batch (second pass of a streamed transform)
+    static void normalizeColumn(Dataset& batch, int colIndex, const ColumnStats& stats) {
+        batch.materializeRows();
+        double x;
+        double range = stats.maxVal - stats.minVal;
+        for (auto& row : batch.rows)
+            if ((size_t)colIndex < row.size() && parseNumeric(row[colIndex], x))
+                row[colIndex] = toString((x - stats.minVal) / range);
+        batch.invalidateColumns();
+    }
+
+    static void standardizeColumn(Dataset& batch, int colIndex, const ColumnStats& stats) {
+        batch.materializeRows();
+        double x;
+        double stddev = stats.stddev();
+        for (auto& row : batch.rows)
+            if ((size_t)colIndex < row.size() && parseNumeric(row[colIndex], x))
+                row[colIndex] = toString((x - stats.mean) / stddev);
+        batch.invalidateColumns();
+    }
+};
+
+// --- Declarative multi-column preprocessing ---
+// Register one transform per column, then run(): a single fused parallel pass gathers
+// the statistics of every registered column from the typed columns, and a second pass
+// writes the transformed values straight into numeric column buffers.
+class PreprocessingPipeline {
+public:
+    enum Op { NORMALIZE, STANDARDIZE, ENCODE, DISCRETIZE };
+
+    struct Step {
+        int col;
+        Op op;
+        int bins = 0;
+        string method;
+    };
+
+    int numThreads = 0;  // 0 = hardware concurrency
+    bool verbose = true;
+
+    PreprocessingPipeline& normalize(int col) { return add({col, NORMALIZE, 0, ""}); }
+    PreprocessingPipeline& standardize(int col) { return add({col, STANDARDIZE, 0, ""}); }
+    PreprocessingPipeline& encode(int col) { return add({col, ENCODE, 0, ""}); }
+    PreprocessingPipeline& discretize(int col, int bins, const string& method = "equal-width") {
+        return add({col, DISCRETIZE, bins, method});
+    }
+
+    // --- Apply every registered transform; data keeps its columnar form ---
+    void run(Dataset& data) {
+        ColumnStore cs = std::move(data.mutableColumns());
+        size_t n = cs.nRows;
+
+        // Views are fetched up front: filling a column's double cache is not thread-safe
+        vector<NumericView> inputs;
+        for (auto& s : steps) inputs.push_back(cs.numeric(s.col));
+
+        // Pass 1: statistics for all columns, per-thread partials merged afterwards
+        int threads = Parallel::resolveThreads(numThreads, max<size_t>(1, n / 4096));
+        vector<vector<ColumnStats>> partial(threads, vector<ColumnStats>(steps.size()));
+        Parallel::forRange(n, threads, [&](size_t b, size_t e, int t) {
+            for (size_t k = 0; k < steps.size(); k++) {
+                if (steps[k].op == ENCODE) continue;
+                ColumnStats& st = partial[t][k];
+                const double* x = inputs[k].begin();
+                for (size_t i = b; i < e; i++)
+                    if (!std::isnan(x[i])) st.add(x[i]);
+            }
+        });
+
+        vector<ColumnStats> stats(steps.size());
+        for (auto& p : partial)
+            for (size_t k = 0; k < steps.size(); k++) stats[k].merge(p[k]);
+
+        vector<vector<double>> cuts(steps.size());
+        vector<bool> skip(steps.size(), false);
+        for (size_t k = 0; k < steps.size(); k++) {
+            const Step& s = steps[k];
+            const string& name = data.headers[s.col];
+            if (s.op == ENCODE) {
+                if (verbose) cout << "Encoding column '" << name << "'\n";
+                continue;
+            }
+            if (stats[k].count == 0) {
+                if (verbose) cout << "Column " << name << " has no numeric data.\n";
+                skip[k] = true;
+                continue;
+            }
+            if (s.op == NORMALIZE && verbose)
+                cout << "Normalizing column '" << name << "' using Min-Max ["
+                     << stats[k].minVal << ", " << stats[k].maxVal << "]\n";
+            if (s.op == STANDARDIZE && verbose)
+                cout << "Standardizing column '" << name << "' (mean=" << stats[k].mean
+                     << ", std=" << stats[k].stddev() << ")\n";
+            if (s.op == DISCRETIZE) {
+                cuts[k] = cutPoints(inputs[k], stats[k], s.bins, s.method);
+                if (verbose)
+                    cout << "Discretizing column '" << name << "' into " << s.bins
+                         << " bins (" << s.method << ")\n";
+            }
+        }
+
+        // Pass 2: write the outputs
+        vector<Column> out(steps.size());
+        vector<bool> mapped(steps.size(), false);
+        for (size_t k = 0; k < steps.size(); k++) {
+            if (skip[k]) continue;
+            const Column& src = cs.cols[steps[k].col];
+            const ColumnStats& st = stats[k];
+            const vector<double>& c = cuts[k];
+            if (steps[k].op == ENCODE) out[k] = encodeColumn(src);
+            else if (src.type == COL_CATEGORICAL) {
+                // Mixed column: transform per dictionary entry so non-numeric cells stay as they are
+                mapped[k] = true;
+                Op op = steps[k].op;
+                out[k] = transformDictionary(src, [&](double x) {
+                    if (op == NORMALIZE) return Column::formatNumber((x - st.minVal) / (st.maxVal - st.minVal));
+                    if (op == STANDARDIZE) return Column::formatNumber((x - st.mean) / st.stddev());
+                    return "Bin" + to_string(lower_bound(c.begin(), c.end(), x) - c.begin() + 1);
+                });
+            } else if (steps[k].op == DISCRETIZE) {
+                out[k].type = COL_CATEGORICAL;
+                out[k].codes.resize(n);
+                for (int b = 0; b < steps[k].bins; b++)
+                    out[k].dict.push_back("Bin" + to_string(b + 1));
+                if (stats[k].count < n) out[k].dict.push_back("");  // missing cells stay empty
+            } else {
+                out[k].type = COL_NUMERIC;
+                out[k].values.resize(n);
+            }
+        }
+
+        Parallel::forRange(n, threads, [&](size_t b, size_t e, int) {
+            for (size_t k = 0; k < steps.size(); k++) {
+                if (skip[k] || mapped[k] || steps[k].op == ENCODE) continue;
+                const double* x = inputs[k].begin();
+                const ColumnStats& st = stats[k];
+
+                if (steps[k].op == NORMALIZE) {
+                    double range = st.maxVal - st.minVal;
+                    for (size_t i = b; i < e; i++) out[k].values[i] = (x[i] - st.minVal) / range;
+                } else if (steps[k].op == STANDARDIZE) {
+                    double sd = st.stddev();
+                    for (size_t i = b; i < e; i++) out[k].values[i] = (x[i] - st.mean) / sd;
+                } else {
+                    // Bin index = number of cut points strictly below x
+                    const vector<double>& c = cuts[k];
+                    int32_t missing = steps[k].bins;
+                    for (size_t i = b; i < e; i++)
+                        out[k].codes[i] = std::isnan(x[i]) ? missing
+                                          : lower_bound(c.begin(), c.end(), x[i]) - c.begin();
+                }
+            }
+        });
+
+        for (size_t k = 0; k < steps.size(); k++)
+            if (!skip[k]) cs.cols[steps[k].col] = std::move(out[k]);
+        data.setColumns(std::move(cs));
+    }
+
+private:
+    vector<Step> steps;
+
+    PreprocessingPipeline& add(Step s) {
+        for (auto& existing : steps)
+            if (existing.col == s.col) { existing = s; return *this; }
+        steps.push_back(s);
+        return *this;
+    }
+
+    // Rewrites each numeric dictionary entry once; codes carry over, merging entries
+    // that map to the same text (e.g. "1" and "1.0")
+    static Column transformDictionary(const Column& in, const function<string(double)>& f) {
+        Column out;
+        out.type = COL_CATEGORICAL;
+        const vector<string>& words = in.dictionary();
+        vector<int32_t> remap(words.size());
+        unordered_map<string, int32_t> ids;
+        for (size_t w = 0; w < words.size(); w++) {
+            double x = Column::parseNumber(words[w]);
+            string text = std::isnan(x) ? words[w] : f(x);
+            auto it = ids.emplace(text, (int32_t)out.dict.size());
+            if (it.second) out.dict.push_back(text);
+            remap[w] = it.first->second;
+        }
+        const int32_t* codes = in.codeData();
+        out.codes.resize(in.size());
+        for (size_t i = 0; i < out.codes.size(); i++) out.codes[i] = remap[codes[i]];
+        return out;
+    }
+
+    static vector<double> cutPoints(NumericView x, const ColumnStats& st, int bins, const string& method) {
+        vector<double> cuts;
+        if (method == "equal-width") {
+            double width = (st.maxVal - st.minVal) / bins;
+            for (int i = 1; i < bins; i++) cuts.push_back(st.minVal + i * width);
+        } else if (method == "equal-frequency") {
+            vector<double> values;
+            values.reserve(st.count);
+            for (double v : x)
+                if (!std::isnan(v)) values.push_back(v);
+            for (int i = 1; i < bins; i++) {
+                auto nth = values.begin() + i * values.size() / bins;
+                nth_element(values.begin(), nth, values.end());
+                cuts.push_back(*nth);
+            }
+        }
+        return cuts;
+    }
+
+    // Label encoding in first-appearance order (same numbering as categoricalToNumeric)
+    static Column encodeColumn(const Column& in) {
+        Column out;
+        out.type = COL_INTEGER;
+        size_t n = in.size();
+        out.ints.resize(n);
+
+        if (in.type == COL_CATEGORICAL) {
+            const int32_t* codes = in.codeData();
+            for (size_t i = 0; i < n; i++) out.ints[i] = codes[i];
+            return out;
+        }
+
+        unordered_map<double, int64_t> ids;
+        int64_t nextId = 0, missingId = -1;  // NaN != NaN, so missing cells get one id here
+        NumericView x = in.numeric();
+        for (size_t i = 0; i < n; i++) {
+            if (std::isnan(x[i])) {
+                if (missingId < 0) missingId = nextId++;
+                out.ints[i] = missingId;
+                continue;
+            }
+            auto it = ids.find(x[i]);
+            if (it == ids.end()) it = ids.emplace(x[i], nextId++).first;
+            out.ints[i] = it->second;
+        }
+        return out;
+    }
 };